@@ -10,37 +10,108 @@
 
 #include "CompressorBand.h"
 
-void CompressorBand::prepare(const juce::dsp::ProcessSpec& spec)
+void CompressorBand::prepare(const juce::dsp::ProcessSpec& spec, const DSPKernels::Table& kernels)
 {
-    compressor.prepare(spec);
+    compressor.prepare(spec, kernels);
+    skipped = false;
 }
 
-void CompressorBand::updateCompressorSettings()
+void CompressorBand::updateCompressorSetting(Params::BandParam param)
 {
-    compressor.setAttack(attack -> get());
-    compressor.setRelease(release -> get());
-    compressor.setThreshold(threshold -> get());
-    // Use a helper function to get the ratio value from the choicebox string array
-    compressor.setRatio(ratio -> getCurrentChoiceName().getFloatValue());
+    using Params::BandParam;
+    
+    switch(param)
+    {
+        case BandParam::Attack:
+            compressor.setAttack(attack -> get());
+            break;
+        case BandParam::Release:
+            compressor.setRelease(release -> get());
+            break;
+        case BandParam::Threshold:
+            compressor.setThreshold(threshold -> get());
+            break;
+        case BandParam::Ratio:
+            // The choice names are built from the same table, so the index is all that is needed
+            compressor.setRatio(Params::RatioChoices[static_cast<size_t>(ratio -> getIndex())]);
+            break;
+        case BandParam::Knee:
+            compressor.setKnee(knee -> get());
+            break;
+        case BandParam::Detector:
+            // The detector choices are listed in the same order as DSPKernels::Detector
+            compressor.setDetector(static_cast<DSPKernels::Detector>(detector -> getIndex()));
+            break;
+        case BandParam::Bypassed:
+        case BandParam::Mute:
+        case BandParam::Solo:
+            // These are read when the block is processed
+            break;
+    }
 }
 
-void CompressorBand::process(juce::AudioBuffer<float>& buffer)
+void CompressorBand::processTile(juce::dsp::AudioBlock<float>& tile, bool isFirstTile, bool isLastTile)
 {
-    auto preRMS = computeRMSLevel(buffer);
+    // The followers stopped when the band was skipped, so they start again from where the band is now
+    if(skipped)
+    {
+        compressor.settle(tile);
+        skipped = false;
+    }
+    
+    // Every tile of a block is processed with the same settings, whatever the host does in between
+    if(isFirstTile)
+    {
+        compressor.setControlInterval(gainControlInterval.load(std::memory_order_relaxed));
+        compressor.clearMeters();
+        tileBypassed = bypassed -> get();
+    }
     
-    // The compressor needs a context to process audio and the context needs an audio block to be constructed
-    auto block = juce::dsp::AudioBlock<float>(buffer);
-    auto context = juce::dsp::ProcessContextReplacing<float>(block);
-    context.isBypassed = bypassed -> get();
+    // The compressor processes the band's view of the band arena in place
+    auto context = juce::dsp::ProcessContextReplacing<float>(tile);
+    context.isBypassed = tileBypassed;
     compressor.process(context);
     
-    auto postRMS = computeRMSLevel(buffer);
+    // The meters add up over the tiles, so they only mean something once the whole block is through
+    if(!isLastTile)
+    {
+        return;
+    }
+    
+    // The kernels meter the levels and track the deepest reduction while they pass over the samples, so none of these
+    // need a pass of their own
+    gainReductionDb.store(compressor.getDeepestGainReductionDb());
     
     auto convertToDb = [](auto input)
     {
-        return juce::Decibels::gainToDecibels(input);
+        return FastMath::gainToDecibels(input);
     };
     
-    rmsInputLevelDb.store(convertToDb(preRMS));
-    rmsOutputLevelDb.store(convertToDb(postRMS));
+    rmsInputLevelDb.store(convertToDb(compressor.getInputRMS()));
+    rmsOutputLevelDb.store(convertToDb(compressor.getOutputRMS()));
+    peakInputLevelDb.store(convertToDb(compressor.getInputPeak()));
+    peakOutputLevelDb.store(convertToDb(compressor.getOutputPeak()));
+}
+
+void CompressorBand::skip()
+{
+    skipped = true;
+    clearMeters();
+}
+
+void CompressorBand::reset()
+{
+    compressor.reset();
+    skipped = false;
+    clearMeters();
+}
+
+void CompressorBand::clearMeters()
+{
+    // Nothing is measured or reduced
+    gainReductionDb.store(0.f);
+    rmsInputLevelDb.store(NEGATIVE_INFINITY);
+    rmsOutputLevelDb.store(NEGATIVE_INFINITY);
+    peakInputLevelDb.store(NEGATIVE_INFINITY);
+    peakOutputLevelDb.store(NEGATIVE_INFINITY);
 }
@@ -12,11 +12,13 @@
 
 #include <JuceHeader.h>
 #include "../GUI/Utilities.h"
+#include "CompressorKernel.h"
+#include "Params.h"
 
 struct CompressorBand
 {
     
-    // Note that the "compressor" instance used in this struct's member functions is the private member that is actually a juce::dsp::Compressor<float> object
+    // Note that the "compressor" instance used in this struct's member functions is the private member that is actually a CompressorKernel<float> object
     // The "compressor" instance used outside of this struct are all instances of the CompressorBand struct
     
     // Create caching pointers to the audio parameters
@@ -24,36 +26,59 @@ struct CompressorBand
     juce::AudioParameterFloat* release {nullptr};
     juce::AudioParameterFloat* threshold {nullptr};
     juce::AudioParameterChoice* ratio {nullptr};
+    juce::AudioParameterFloat* knee {nullptr};
+    juce::AudioParameterChoice* detector {nullptr};
     juce::AudioParameterBool* bypassed {nullptr};
     juce::AudioParameterBool* mute {nullptr};
     juce::AudioParameterBool* solo {nullptr};
     
-    void prepare(const juce::dsp::ProcessSpec& spec);
-    void updateCompressorSettings();
-    void process(juce::AudioBuffer<float>& buffer);
+    void prepare(const juce::dsp::ProcessSpec& spec, const DSPKernels::Table& kernels);
+    // Passes one parameter on to the compressor. Only called for parameters that have changed (see ParameterSnapshot.h)
+    void updateCompressorSetting(Params::BandParam param);
     
+    // Compresses a block that arrives in consecutive tiles, in place. The settings are read on the first tile and the
+    // meters published after the last, so a block processed whole is a single tile that is both. A band that was
+    // skipped settles on its first tile alone
+    void processTile(juce::dsp::AudioBlock<float>& tile, bool isFirstTile, bool isLastTile);
+    
+    // Called instead of processTile for a block of a band that is muted or not soloed, so no one would hear it
+    // The compressor is not run at all, and settles on the band's level again when it is next processed
+    void skip();
+    
+    // Drops the compressor's state, e.g. after a long silence. The meters read silence until the next block
+    void reset();
+    
+    // True when the next block has to settle the compressor first
+    bool isSkipped() const { return skipped; }
+    
+    void copyChannelState(size_t source, size_t destination) { compressor.copyChannelState(source, destination); }
+    
+    // Runs the gain computer every interval samples instead of on every sample, from the next block. Rounded down to
+    // 1, 8, 16 or 32, see CompressorKernel::setControlInterval for the error each costs. 1 is audio rate
+    void setGainControlInterval(size_t interval) { gainControlInterval = CompressorKernel<float>::getSupportedControlInterval(interval); }
+    
+    // The levels of the last block over all of the band's channels, metered by the compressor while it processes
     float getRMSInputLevelDb() const {return rmsInputLevelDb;};
     float getRMSOutputLevelDb() const {return rmsOutputLevelDb;};
+    float getPeakInputLevelDb() const {return peakInputLevelDb;};
+    float getPeakOutputLevelDb() const {return peakOutputLevelDb;};
+    
+    // The band's gain reduction output: the deepest reduction the compressor applied in the last block, in dB (0 or
+    // below). The kernels track it while they apply the gain, so it is exactly what the audio received
+    float getGainReductionDb() const {return gainReductionDb;};
 
 private:
-    juce::dsp::Compressor<float> compressor;
+    CompressorKernel<float> compressor;
     
     std::atomic<float> rmsInputLevelDb {NEGATIVE_INFINITY};
     std::atomic<float> rmsOutputLevelDb {NEGATIVE_INFINITY};
-
-    template<typename T>
-    float computeRMSLevel(const T& buffer)
-    {
-        int numChannels = static_cast<int>(buffer.getNumChannels());
-        int numSamples = static_cast<int>(buffer.getNumSamples());
-        auto rms = 0.f;
-        for(int chan = 0; chan < numChannels; ++chan)
-        {
-            rms += buffer.getRMSLevel(chan, 0, numSamples);
-        }
-        
-        rms /= static_cast<float>(numChannels);
-        return rms;
-    }
+    std::atomic<float> peakInputLevelDb {NEGATIVE_INFINITY};
+    std::atomic<float> peakOutputLevelDb {NEGATIVE_INFINITY};
+    std::atomic<float> gainReductionDb {0.f};
+    std::atomic<size_t> gainControlInterval {1};
+    
+    bool skipped {false};
+    bool tileBypassed {false};
     
+    void clearMeters();
 };
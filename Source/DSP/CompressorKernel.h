@@ -0,0 +1,407 @@
+/*
+  ==============================================================================
+
+    CompressorKernel.h
+    Created: 16 Oct 2026 10:40:51am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+#include "SIMDHelpers.h"
+
+/*
+ The band compressor, with the channels packed into SIMD lanes
+
+ The envelope is the only recursive part of the compressor. Its detector and attack/release followers for all
+ channels are advanced together in the lanes of one register by DSPKernels::Table::followEnvelope and written to
+ an envelope buffer, after which DSPKernels::Table::computeGain runs over each channel as a plain loop with no
+ dependency between samples. The gain computer works in dB with an optional soft knee, and keeps the deepest gain
+ reduction it applies as it goes, which is the band's gain reduction meter.
+
+ The two passes also meter the input and the output as they go, so metering a band costs no passes of its own.
+ The meters add up every process call since the last clearMeters, so a block can also be processed in tiles.
+
+ Below the knee the gain computer returns exactly 0 dB, i.e. a gain of exactly 1. The follower reports the largest
+ envelope value of the block, and a block whose envelope stayed more than the knee width below the threshold skips
+ the gain computer altogether: its output would have been its input, bit for bit. The follower itself always runs,
+ so the next block that does need compressing starts from the same state it would have had anyway.
+
+ With the peak detector and a hard knee this is the same curve as juce::dsp::Compressor.
+ */
+template<typename SampleType, size_t MaxChannels = 2>
+struct CompressorKernel
+{
+    static_assert(std::is_same<SampleType, float>::value, "The envelope kernels are single precision");
+    static_assert(MaxChannels <= DSPKernels::MaxLanes, "Every channel needs its own lane");
+
+    using Detector = DSPKernels::Detector;
+
+    CompressorKernel()
+    {
+        updateTruePeakTaps();
+        controlGain.fill(1);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec, const DSPKernels::Table& kernelTable)
+    {
+        jassert(spec.numChannels <= MaxChannels);
+
+        kernels = &kernelTable;
+        coefficientTable.prepare(spec.sampleRate);
+
+        // The envelope and the control rate ramp of every channel share one aligned arena
+        arenaBlock = juce::dsp::AudioBlock<SampleType>(arena,
+                                                       MaxChannels * 2,
+                                                       spec.maximumBlockSize,
+                                                       SIMDHelpers::LaneAlignment);
+        envelope = arenaBlock.getSubsetChannelBlock(0, MaxChannels);
+        controlRamp = arenaBlock.getSubsetChannelBlock(MaxChannels, MaxChannels);
+        arenaBlock.clear();
+
+        updateGainCurve();
+        updateTimeConstants();
+        updateIdleLevel();
+        reset();
+    }
+
+    void reset()
+    {
+        envelopeState.fill(0);
+        rmsState.fill(0);
+        truePeakHistory.fill(0);
+        truePeakPosition = 0;
+        controlGain.fill(1);
+        clearMeters();
+    }
+
+    // Starts the meters and the deepest gain reduction of a new block
+    void clearMeters()
+    {
+        blockInputMeter = {0, 0};
+        blockOutputMeter = {0, 0};
+        meteredValues = 0;
+        deepestGainReductionDb = 0;
+    }
+
+    // Gives channel destination the detector state of channel source
+    void copyChannelState(size_t source, size_t destination)
+    {
+        jassert(source < MaxChannels && destination < MaxChannels);
+
+        envelopeState[destination] = envelopeState[source];
+        rmsState[destination] = rmsState[source];
+        controlGain[destination] = controlGain[source];
+        for(size_t frame = 0; frame < 2 * DSPKernels::TruePeakTaps; ++frame)
+        {
+            truePeakHistory[frame * DSPKernels::MaxLanes + destination] = truePeakHistory[frame * DSPKernels::MaxLanes + source];
+        }
+    }
+
+    void setThreshold(SampleType newThresholdDb)
+    {
+        thresholdDb = newThresholdDb;
+        updateIdleLevel();
+    }
+
+    void setRatio(SampleType newRatio)
+    {
+        jassert(newRatio >= static_cast<SampleType>(1.0));
+        ratio = newRatio;
+        updateGainCurve();
+    }
+
+    void setAttack(SampleType newAttackMs)
+    {
+        attackMs = newAttackMs;
+        cteAttack = coefficientTable.get(attackMs);
+    }
+
+    void setRelease(SampleType newReleaseMs)
+    {
+        releaseMs = newReleaseMs;
+        cteRelease = coefficientTable.get(releaseMs);
+    }
+
+    // The width of the soft knee in dB, centred on the threshold. 0 is a hard knee
+    void setKnee(SampleType newKneeDb)
+    {
+        jassert(newKneeDb >= 0);
+        kneeDb = newKneeDb;
+        updateGainCurve();
+        updateIdleLevel();
+    }
+
+    // The largest control interval, which every other one divides. Tiles that are a multiple of it cut the control
+    // rate segments in the same places as the whole block would
+    static constexpr size_t maxControlInterval = 32;
+
+    /*
+     How often the gain computer runs: 1 for every sample, or every 8, 16 or 32 samples with the gain ramped in
+     between. The error against audio rate grows with the interval and shrinks as the attack gets slower. Measured
+     at 48 kHz on a 220 Hz sine with white noise 20 dB below it, stepping between -26 and -6 dBFS every half second,
+     peak detector, threshold -30 dB, ratio 5, 6 dB knee, 100 ms release. Each entry is the largest output error as
+     a fraction of the output's peak / the largest gain error in dB / the mean gain error in dB, the gain errors
+     where the input is above -60 dBFS:
+
+         attack    every 8 samples         every 16 samples        every 32 samples
+           5 ms    0.041 / 0.39 / 0.0036   0.081 / 1.14 / 0.0099   0.115 / 1.31 / 0.0312
+          10 ms    0.021 / 0.28 / 0.0028   0.050 / 0.75 / 0.0084   0.107 / 1.18 / 0.0283
+          20 ms    0.011 / 0.19 / 0.0021   0.027 / 0.46 / 0.0068   0.081 / 0.96 / 0.0242
+          50 ms    0.005 / 0.08 / 0.0015   0.012 / 0.19 / 0.0051   0.049 / 0.61 / 0.0186
+         100 ms    0.003 / 0.03 / 0.0011   0.008 / 0.09 / 0.0040   0.022 / 0.30 / 0.0145
+         200 ms    0.001 / 0.02 / 0.0008   0.004 / 0.05 / 0.0031   0.012 / 0.15 / 0.0108
+         500 ms    0.000 / 0.02 / 0.0006   0.001 / 0.03 / 0.0021   0.004 / 0.08 / 0.0071
+
+     The largest errors all fall on the attack right after a step up. A new interval takes effect from the next
+     block, ramping on from the gain the last one ended on. Any other interval is rounded down to one of these (see
+     getSupportedControlInterval). The ControlRate tests in Tools/DSPTests measure this table and fail if an entry
+     grows.
+     */
+    void setControlInterval(size_t newControlInterval)
+    {
+        controlInterval = getSupportedControlInterval(newControlInterval);
+    }
+
+    // The largest of 1, 8, 16 and 32 that is no larger than the interval asked for. 0 counts as 1
+    static constexpr size_t getSupportedControlInterval(size_t interval)
+    {
+        return interval >= maxControlInterval ? maxControlInterval
+             : interval >= 16 ? 16
+             : interval >= 8 ? 8
+             : 1;
+    }
+
+    void setDetector(Detector newDetector)
+    {
+        // The followers of the old detector hold levels in a different domain, so they restart from silence
+        if(newDetector != detector)
+        {
+            detector = newDetector;
+            updateIdleLevel();
+            reset();
+        }
+    }
+
+    /*
+     Restarts the detector at the steady state for the level of block, instead of from the state it was left in
+
+     For a compressor that has not seen the signal for a while, e.g. a band that was muted. Its followers would
+     otherwise start from a level that is long gone and pump or overshoot once it is heard again. The block is only
+     read, and still has to be processed afterwards.
+     */
+    void settle(const juce::dsp::AudioBlock<const SampleType>& block)
+    {
+        reset();
+
+        const auto numSamples = block.getNumSamples();
+        for(size_t channel = 0; channel < block.getNumChannels() && numSamples > 0; ++channel)
+        {
+            const auto* samples = block.getChannelPointer(channel);
+            DSPKernels::Meter meter;
+            kernels->measure(&samples, 1, numSamples, meter);
+
+            // The envelope is in the same domain as the detector: a mean square for RMS, an amplitude otherwise
+            // A peak follower with a release settles well below the peaks it follows, nearer the RMS of the signal
+            auto meanSquare = meter.sumOfSquares / static_cast<SampleType>(numSamples);
+            if(detector == Detector::RMS)
+            {
+                rmsState[channel] = meanSquare;
+                envelopeState[channel] = meanSquare;
+            }
+            else
+            {
+                envelopeState[channel] = std::sqrt(meanSquare);
+            }
+        }
+    }
+
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
+    {
+        auto& block = context.getOutputBlock();
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples = block.getNumSamples();
+        jassert(numChannels <= MaxChannels);
+        jassert(numSamples <= envelope.getNumSamples());
+
+        if(context.isBypassed)
+        {
+            // Nothing else passes over a bypassed block, so it is metered on its own. Its output is its input
+            std::array<const SampleType*, MaxChannels> channels {};
+            for(size_t channel = 0; channel < numChannels; ++channel)
+            {
+                channels[channel] = block.getChannelPointer(channel);
+            }
+
+            kernels->measure(channels.data(), numChannels, numSamples, inputMeter);
+            outputMeter = inputMeter;
+            addToMeters(numChannels * numSamples, 0);
+            return;
+        }
+
+        std::array<SampleType*, MaxChannels> samples {};
+        std::array<SampleType*, MaxChannels> env {};
+        std::array<SampleType*, MaxChannels> ramp {};
+        for(size_t channel = 0; channel < numChannels; ++channel)
+        {
+            samples[channel] = block.getChannelPointer(channel);
+            env[channel] = envelope.getChannelPointer(channel);
+            ramp[channel] = controlRamp.getChannelPointer(channel);
+        }
+
+        // Pass 1: the envelopes of every channel advance side by side, one lane per channel
+        kernels->followEnvelope({samples.data(), env.data(), numChannels, numSamples,
+                                 cteAttack, cteRelease,
+                                 envelopeState.data(),
+                                 detector,
+                                 cteRms, rmsState.data(),
+                                 truePeakTaps.data(), truePeakHistory.data(), &truePeakPosition,
+                                 &inputMeter, &envelopePeak});
+
+        // Nowhere near the knee, so every gain would have been exactly 1. At control rate the ramps have to have
+        // reached 1 as well
+        if(envelopePeak < idleLevel && (controlInterval == 1 || controlGainsAreUnity(numChannels)))
+        {
+            std::fill(controlGain.begin(), controlGain.begin() + numChannels, static_cast<SampleType>(1));
+            outputMeter = inputMeter;
+            addToMeters(numChannels * numSamples, 0);
+            return;
+        }
+
+        // Pass 2: the gain computer has no state, so it runs over whole registers of samples
+        auto deepestDb = kernels->computeGain({samples.data(), env.data(), numChannels, numSamples,
+                                               thresholdDb, kneeDb * static_cast<SampleType>(0.5), slope, kneeFactor,
+                                               detector == Detector::RMS ? log2ToDbPower : log2ToDbAmplitude,
+                                               controlInterval, ramp.data(), controlGain.data(),
+                                               &outputMeter});
+        addToMeters(numChannels * numSamples, deepestDb);
+    }
+
+    // The deepest gain reduction since clearMeters in dB, 0 or below
+    SampleType getDeepestGainReductionDb() const { return deepestGainReductionDb; }
+
+    // The RMS over every channel and the peak since clearMeters, as gains, before and after compression
+    SampleType getInputRMS() const { return blockInputMeter.getRMS(meteredValues); }
+    SampleType getOutputRMS() const { return blockOutputMeter.getRMS(meteredValues); }
+    SampleType getInputPeak() const { return blockInputMeter.peak; }
+    SampleType getOutputPeak() const { return blockOutputMeter.peak; }
+
+private:
+    // 20 log10(2) and 10 log10(2)
+    static constexpr SampleType log2ToDbAmplitude = static_cast<SampleType>(6.020599913279624);
+    static constexpr SampleType log2ToDbPower = static_cast<SampleType>(3.010299956639812);
+
+    // The window of the RMS detector
+    static constexpr SampleType rmsWindowMs = 10;
+
+    // How far below the knee the envelope has to stay for the gain computer to be skipped. Far more than the error
+    // of the gain computer's log2, so the skipped gains are provably 0 dB
+    static constexpr SampleType idleMarginDb = static_cast<SampleType>(0.1);
+
+    // Each setter only recomputes what depends on its own setting. The threshold is used as it is
+    void updateGainCurve()
+    {
+        slope = static_cast<SampleType>(1.0) / ratio - static_cast<SampleType>(1.0);
+        kneeFactor = kneeDb > 0 ? slope / (static_cast<SampleType>(2.0) * kneeDb) : 0;
+    }
+
+    // The envelope value that the gain computer sees as the bottom of the knee, less the knee width and the margin
+    void updateIdleLevel()
+    {
+        auto idleDb = thresholdDb - kneeDb - idleMarginDb;
+        idleLevel = juce::Decibels::decibelsToGain(idleDb, static_cast<SampleType>(-1000));
+
+        // The RMS envelope is a mean square
+        if(detector == Detector::RMS)
+            idleLevel *= idleLevel;
+    }
+
+    // Adds the levels the kernels metered in one process call to those of the block
+    void addToMeters(size_t numValues, SampleType deepestDb)
+    {
+        blockInputMeter.sumOfSquares += inputMeter.sumOfSquares;
+        blockInputMeter.peak = std::max(blockInputMeter.peak, inputMeter.peak);
+        blockOutputMeter.sumOfSquares += outputMeter.sumOfSquares;
+        blockOutputMeter.peak = std::max(blockOutputMeter.peak, outputMeter.peak);
+        meteredValues += numValues;
+        deepestGainReductionDb = std::min(deepestGainReductionDb, deepestDb);
+    }
+
+    bool controlGainsAreUnity(size_t numChannels) const
+    {
+        return std::all_of(controlGain.begin(), controlGain.begin() + numChannels, [](SampleType gain){ return gain == 1; });
+    }
+
+    void updateTimeConstants()
+    {
+        // The attack and release parameters move in whole milliseconds, so these are table lookups
+        cteAttack = coefficientTable.get(attackMs);
+        cteRelease = coefficientTable.get(releaseMs);
+        cteRms = coefficientTable.get(rmsWindowMs);
+    }
+
+    void updateTruePeakTaps()
+    {
+        // A Blackman windowed sinc interpolator split into its polyphase components, as in ITU-R BS.1770
+        // Phase 0 is the input itself, so only the phases in between the input samples are kept
+        using namespace DSPKernels;
+        constexpr auto length = TruePeakOversampling * TruePeakTaps;
+        const auto pi = juce::MathConstants<double>::pi;
+
+        for(size_t phase = 1; phase < TruePeakOversampling; ++phase)
+        {
+            auto* taps = truePeakTaps.data() + (phase - 1) * TruePeakTaps;
+            double sum = 0;
+
+            for(size_t tap = 0; tap < TruePeakTaps; ++tap)
+            {
+                // Taps are stored oldest sample first
+                auto n = static_cast<double>((TruePeakTaps - 1 - tap) * TruePeakOversampling + phase);
+                auto t = (n - length / 2) / TruePeakOversampling;
+                auto sinc = std::sin(pi * t) / (pi * t);
+                auto window = 0.42 - 0.5 * std::cos(2.0 * pi * n / length) + 0.08 * std::cos(4.0 * pi * n / length);
+
+                taps[tap] = static_cast<float>(sinc * window);
+                sum += taps[tap];
+            }
+
+            // Unity gain at DC for every phase
+            for(size_t tap = 0; tap < TruePeakTaps; ++tap)
+            {
+                taps[tap] = static_cast<float>(taps[tap] / sum);
+            }
+        }
+    }
+
+    const DSPKernels::Table* kernels {DSPKernels::Scalar::getTable()};
+
+    FastMath::EnvelopeCoefficientTable coefficientTable;
+
+    Detector detector {Detector::Peak};
+    SampleType thresholdDb {0}, ratio {1}, attackMs {1}, releaseMs {100}, kneeDb {0};
+    SampleType slope {0}, kneeFactor {0}, idleLevel {0};
+    SampleType cteAttack {0}, cteRelease {0}, cteRms {0};
+
+    alignas(SIMDHelpers::LaneAlignment) std::array<SampleType, DSPKernels::MaxLanes> envelopeState {};
+    alignas(SIMDHelpers::LaneAlignment) std::array<SampleType, DSPKernels::MaxLanes> rmsState {};
+    alignas(SIMDHelpers::LaneAlignment) std::array<SampleType, 2 * DSPKernels::TruePeakTaps * DSPKernels::MaxLanes> truePeakHistory {};
+    std::array<float, (DSPKernels::TruePeakOversampling - 1) * DSPKernels::TruePeakTaps> truePeakTaps {};
+    size_t truePeakPosition {0};
+
+    size_t controlInterval {1};
+    alignas(SIMDHelpers::LaneAlignment) std::array<SampleType, DSPKernels::MaxLanes> controlGain {};
+
+    juce::HeapBlock<char> arena;
+    juce::dsp::AudioBlock<SampleType> arenaBlock, envelope, controlRamp;
+
+    SampleType deepestGainReductionDb {0}, envelopePeak {0};
+
+    // What the kernels metered in the last process call, and the sum since clearMeters
+    DSPKernels::Meter inputMeter {0, 0}, outputMeter {0, 0};
+    DSPKernels::Meter blockInputMeter {0, 0}, blockOutputMeter {0, 0};
+    size_t meteredValues {0};
+};
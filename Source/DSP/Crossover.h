@@ -0,0 +1,346 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 16 Oct 2026 9:12:40am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+#include "SIMDHelpers.h"
+
+/*
+ Crossover<NumBands> splits a signal into NumBands phase aligned Linkwitz-Riley bands
+
+ The cascade is generated from NumBands at compile time. For crossovers fc0 < fc1 < ... the scheme is:
+
+     band 0:  LP(fc0) -> AP(fc1) -> AP(fc2) -> ...
+     band 1:  HP(fc0) -> LP(fc1) -> AP(fc2) -> ...
+     band 2:  HP(fc0) -> HP(fc1) -> LP(fc2) -> ...
+     ...
+
+ Each crossover is a single filter that produces its low and high outputs from the same state, and every
+ band that has already been split off below a crossover passes through that crossover's allpass exactly once
+ so that all bands sum back to a flat magnitude response. For three bands this is the LP1/AP2/HP1/LP2/HP2 tree.
+
+ Every filter that runs at a crossover's frequency shares its coefficients, so they are packed into SIMD lanes
+ and advanced together: lane (slot * MaxChannels + channel) holds one signal, where slot b is band b once it has
+ been split off and the slot above the last split holds the remainder still to be split. Crossover c therefore
+ always works on the contiguous lanes of slots 0 to c. The per-sample loop itself is DSPKernels::Table::splitBands,
+ so the register width is whatever table prepare was given.
+
+ Left untouched, the bands sum back to AP(fc0) -> AP(fc1) -> ... of the input. processAllpass runs just that chain,
+ for when nothing between the split and the sum would change the signal.
+
+ The crossover tests in Tools/DSPTests check the bands against juce::dsp::LinkwitzRileyFilter and their sum for flatness.
+ */
+template<size_t NumBands, size_t MaxChannels = 2>
+struct Crossover
+{
+    static_assert(NumBands >= 2 && NumBands <= 8, "Crossover supports between 2 and 8 bands");
+
+    static constexpr size_t NumCrossovers = NumBands - 1;
+
+    using BandBlocks = std::array<juce::dsp::AudioBlock<float>, NumBands>;
+
+    Crossover()
+    {
+        for(size_t crossover = 0; crossover < NumCrossovers; ++crossover)
+        {
+            auto& stage = stages[crossover];
+
+            // Slot c takes the low output of the split, the slots below it take the allpass output
+            // Lanes above slot c are padding for this crossover and are left untouched
+            for(size_t lane = 0; lane < NumPaddedLanes; ++lane)
+            {
+                auto slot = lane / MaxChannels;
+                stage.lowLanes[lane] = slot == crossover ? AllLanesSet : 0;
+                stage.activeLanes[lane] = slot <= crossover ? AllLanesSet : 0;
+            }
+
+            kernelStages[crossover] = {0, 0, 0, 0,
+                                       stage.s1.data(), stage.s2.data(), stage.s3.data(), stage.s4.data(),
+                                       stage.lowLanes.data(), stage.activeLanes.data()};
+            updateCoefficients(crossover);
+        }
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec, const DSPKernels::Table& kernelTable)
+    {
+        jassert(spec.numChannels <= MaxChannels);
+
+        kernels = &kernelTable;
+        sampleRate = spec.sampleRate;
+        for(size_t crossover = 0; crossover < NumCrossovers; ++crossover)
+        {
+            updateCoefficients(crossover);
+        }
+
+        reset();
+    }
+
+    void reset()
+    {
+        for(auto& stage : stages)
+        {
+            stage.s1.fill(0);
+            stage.s2.fill(0);
+            stage.s3.fill(0);
+            stage.s4.fill(0);
+        }
+
+        lanes.fill(0);
+
+        for(auto& stage : allpassStages)
+        {
+            stage.s1.fill(0);
+            stage.s2.fill(0);
+        }
+    }
+
+    void setCrossoverFrequency(size_t crossover, float frequency)
+    {
+        jassert(crossover < NumCrossovers);
+        jassert(frequency > 0 && frequency < static_cast<float>(sampleRate * 0.5));
+
+        stages[crossover].cutoff = frequency;
+        updateCoefficients(crossover);
+    }
+
+    /*
+     Filters input out-of-place into the band blocks
+
+     Inputs:
+     - input: the block to split. It is only read from
+     - bands: one block per band, each with the same number of channels and samples as input
+     - inputGains, inputGain: a gain the input is multiplied by on its way into the first stage, one per sample or,
+       when inputGains is nullptr, the same for every sample
+     Outputs:
+     - None
+     - Overwrites every band block
+     */
+    void process(const juce::dsp::AudioBlock<const float>& input, const BandBlocks& bands,
+                 const float* inputGains = nullptr, float inputGain = 1.0f)
+    {
+        const auto numChannels = input.getNumChannels();
+        const auto numSamples = input.getNumSamples();
+        jassert(numChannels <= MaxChannels);
+
+        std::array<const float*, MaxChannels> in {};
+        std::array<float*, NumBands * MaxChannels> out {};
+        for(size_t channel = 0; channel < numChannels; ++channel)
+        {
+            in[channel] = input.getChannelPointer(channel);
+            for(size_t band = 0; band < NumBands; ++band)
+            {
+                jassert(bands[band].getNumChannels() == numChannels && bands[band].getNumSamples() == numSamples);
+                out[band * MaxChannels + channel] = bands[band].getChannelPointer(channel);
+            }
+        }
+
+        // The lanes of a channel the block does not have are still filtered, as they share registers with the rest.
+        // They start from silence when the channel goes away, so they stay silent rather than ringing on a stale sample
+        if(numChannels < activeChannels)
+        {
+            clearChannels(numChannels);
+        }
+
+        activeChannels = numChannels;
+
+        // All filters run per sample, so the input is read once and every band is written once
+        kernels->splitBands({kernelStages.data(), NumCrossovers, MaxChannels,
+                             in.data(), numChannels, numSamples,
+                             inputGains, inputGain,
+                             out.data(),
+                             lanes.data(), highs.data()});
+    }
+
+    /*
+     Filters block in place with the allpass chain the bands sum back to, without splitting it
+
+     The chain has its own state. Every filter involved is linear, so the sum of the bands only depends on the sum
+     of the first section states over the lanes of each crossover. startAllpass and stopAllpass hand that sum over
+     in either direction, so switching between process and processAllpass leaves the summed output continuous.
+     This runs a handful of operations per sample and channel, so it is plain scalar code rather than a kernel.
+     */
+    void processAllpass(const juce::dsp::AudioBlock<float>& block)
+    {
+        jassert(block.getNumChannels() <= MaxChannels);
+
+        for(size_t crossover = 0; crossover < NumCrossovers; ++crossover)
+        {
+            const auto& coefficients = kernelStages[crossover];
+            auto& stage = allpassStages[crossover];
+
+            for(size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            {
+                auto* samples = block.getChannelPointer(channel);
+                auto s1 = stage.s1[channel];
+                auto s2 = stage.s2[channel];
+
+                // The first section of processCrossoverStage, in the same order
+                for(size_t i = 0; i < block.getNumSamples(); ++i)
+                {
+                    auto x = samples[i];
+                    auto yH = (x - coefficients.k * s1 - s2) * coefficients.h;
+                    auto yB = coefficients.g * yH + s1;
+                    s1 = coefficients.g * yH + yB;
+                    auto yL = coefficients.g * yB + s2;
+                    s2 = coefficients.g * yB + yL;
+                    samples[i] = yL - coefficients.R2 * yB + yH;
+                }
+
+                stage.s1[channel] = s1;
+                stage.s2[channel] = s2;
+            }
+        }
+    }
+
+    // Carries the state of the split over to the allpass chain, before the first processAllpass after process
+    void startAllpass()
+    {
+        for(size_t crossover = 0; crossover < NumCrossovers; ++crossover)
+        {
+            const auto& stage = stages[crossover];
+            auto& allpass = allpassStages[crossover];
+
+            for(size_t channel = 0; channel < MaxChannels; ++channel)
+            {
+                allpass.s1[channel] = 0;
+                allpass.s2[channel] = 0;
+
+                // Crossover c filters slots 0 to c
+                for(size_t slot = 0; slot <= crossover; ++slot)
+                {
+                    allpass.s1[channel] += stage.s1[slot * MaxChannels + channel];
+                    allpass.s2[channel] += stage.s2[slot * MaxChannels + channel];
+                }
+            }
+        }
+    }
+
+    // Carries the state of the allpass chain back to the split, before the first process after processAllpass
+    // It all goes to the slot each crossover splits, which leaves the sum exact while that slot's bands settle
+    void stopAllpass()
+    {
+        for(size_t crossover = 0; crossover < NumCrossovers; ++crossover)
+        {
+            auto& stage = stages[crossover];
+            const auto& allpass = allpassStages[crossover];
+
+            stage.s1.fill(0);
+            stage.s2.fill(0);
+            stage.s3.fill(0);
+            stage.s4.fill(0);
+
+            for(size_t channel = 0; channel < MaxChannels; ++channel)
+            {
+                stage.s1[crossover * MaxChannels + channel] = allpass.s1[channel];
+                stage.s2[crossover * MaxChannels + channel] = allpass.s2[channel];
+            }
+        }
+    }
+
+    // Gives channel destination the filter state of channel source, in the split and in the allpass chain
+    void copyChannelState(size_t source, size_t destination)
+    {
+        jassert(source < MaxChannels && destination < MaxChannels);
+
+        for(size_t crossover = 0; crossover < NumCrossovers; ++crossover)
+        {
+            auto& stage = stages[crossover];
+            for(size_t slot = 0; slot < NumBands; ++slot)
+            {
+                auto from = slot * MaxChannels + source;
+                auto to = slot * MaxChannels + destination;
+                stage.s1[to] = stage.s1[from];
+                stage.s2[to] = stage.s2[from];
+                stage.s3[to] = stage.s3[from];
+                stage.s4[to] = stage.s4[from];
+            }
+
+            auto& allpass = allpassStages[crossover];
+            allpass.s1[destination] = allpass.s1[source];
+            allpass.s2[destination] = allpass.s2[source];
+        }
+    }
+
+private:
+    // Every table's register width divides DSPKernels::MaxLanes
+    static constexpr size_t NumLanes = NumBands * MaxChannels;
+    static constexpr size_t NumPaddedLanes = (NumLanes + DSPKernels::MaxLanes - 1) / DSPKernels::MaxLanes * DSPKernels::MaxLanes;
+    static constexpr uint32_t AllLanesSet = ~uint32_t();
+
+    template<typename T>
+    using LaneArray = std::array<T, NumPaddedLanes>;
+
+    struct Stage
+    {
+        float cutoff {1000.0f};
+
+        alignas(SIMDHelpers::LaneAlignment) LaneArray<float> s1 {}, s2 {}, s3 {}, s4 {};
+        alignas(SIMDHelpers::LaneAlignment) LaneArray<uint32_t> lowLanes {}, activeLanes {};
+    };
+
+    void updateCoefficients(size_t crossover)
+    {
+        // The same coefficients as juce::dsp::LinkwitzRileyFilter
+        auto& coefficients = kernelStages[crossover];
+        coefficients.g = static_cast<float>(std::tan(juce::MathConstants<double>::pi * stages[crossover].cutoff / sampleRate));
+        coefficients.R2 = static_cast<float>(std::sqrt(2.0));
+        coefficients.h = static_cast<float>(1.0 / (1.0 + coefficients.R2 * coefficients.g + coefficients.g * coefficients.g));
+        coefficients.k = coefficients.R2 + coefficients.g;
+    }
+
+    // Zeroes the split's lanes and state of every channel from firstChannel up
+    void clearChannels(size_t firstChannel)
+    {
+        for(size_t slot = 0; slot < NumBands; ++slot)
+        {
+            for(size_t channel = firstChannel; channel < MaxChannels; ++channel)
+            {
+                const auto lane = slot * MaxChannels + channel;
+                lanes[lane] = 0;
+                highs[lane] = 0;
+
+                for(auto& stage : stages)
+                {
+                    stage.s1[lane] = 0;
+                    stage.s2[lane] = 0;
+                    stage.s3[lane] = 0;
+                    stage.s4[lane] = 0;
+                }
+            }
+        }
+    }
+
+    double sampleRate {44100.0};
+    const DSPKernels::Table* kernels {DSPKernels::Scalar::getTable()};
+
+    std::array<Stage, NumCrossovers> stages;
+
+    // The first section states of processAllpass, one per channel
+    struct AllpassStage
+    {
+        std::array<float, MaxChannels> s1 {}, s2 {};
+    };
+
+    std::array<AllpassStage, NumCrossovers> allpassStages;
+
+    // The coefficients and state pointers of each stage as the kernels see them
+    std::array<DSPKernels::CrossoverStage, NumCrossovers> kernelStages {};
+
+    // The signals of the sample currently being split, and the high outputs of the last stage
+    alignas(SIMDHelpers::LaneAlignment) LaneArray<float> lanes {}, highs {};
+
+    // The number of channels the last block had
+    size_t activeChannels {MaxChannels};
+
+    // kernelStages points into stages
+    JUCE_DECLARE_NON_COPYABLE(Crossover)
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    DSPKernels.cpp
+    Created: 16 Oct 2026 1:18:06pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+namespace DSPKernels
+{
+
+juce::String getIsaName(Isa isa)
+{
+    switch(isa)
+    {
+        case Isa::Scalar: return "Scalar";
+       #if JUCE_ARM
+        case Isa::SSE2: return "NEON";
+       #else
+        case Isa::SSE2: return "SSE2";
+       #endif
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+    }
+
+    jassertfalse;
+    return {};
+}
+
+bool isSupported(Isa isa)
+{
+    switch(isa)
+    {
+        case Isa::Scalar: return true;
+        // SIMDRegister falls back to plain code on targets without SIMD, so the SSE2 table always exists
+        case Isa::SSE2: return true;
+        case Isa::AVX2: return AVX2::getTable() != nullptr && juce::SystemStats::hasAVX2();
+        case Isa::AVX512: return AVX512::getTable() != nullptr && juce::SystemStats::hasAVX512F();
+    }
+
+    return false;
+}
+
+Isa getBestSupportedIsa()
+{
+    for(auto isa : {Isa::AVX512, Isa::AVX2, Isa::SSE2})
+    {
+        if(isSupported(isa))
+            return isa;
+    }
+
+    return Isa::Scalar;
+}
+
+const Table& getTable(Isa isa)
+{
+    jassert(isSupported(isa));
+
+    switch(isa)
+    {
+        case Isa::AVX512: return *AVX512::getTable();
+        case Isa::AVX2: return *AVX2::getTable();
+        case Isa::SSE2: return *SSE2::getTable();
+        case Isa::Scalar: break;
+    }
+
+    return *Scalar::getTable();
+}
+}
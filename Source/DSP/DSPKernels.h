@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    DSPKernels.h
+    Created: 16 Oct 2026 1:18:06pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+/*
+ The DSP hot loops, built once per instruction set and picked at runtime
+
+ Each instruction set has its own translation unit (DSPKernelsScalar.cpp, DSPKernelsSSE2.cpp, DSPKernelsAVX2.cpp,
+ DSPKernelsAVX512.cpp) which compiles the templates in DSPKernelsImpl.h for its own register type and target.
+ The processor asks for the best table the CPU supports in prepareToPlay and hands it to the crossover and the
+ compressors. The scalar table runs the same operations in the same order one lane at a time, so its output is
+ the reference the vectorised tables are compared against.
+ */
+namespace DSPKernels
+{
+
+enum class Isa
+{
+    Scalar,
+    SSE2,   // juce::dsp::SIMDRegister, so this is NEON on ARM
+    AVX2,
+    AVX512,
+};
+
+// Every lane buffer handed to the kernels is padded to the widest register any table uses
+static constexpr size_t MaxLanes = 16;
+
+// What the compressor's envelope follows
+enum class Detector
+{
+    Peak,       // |x|
+    RMS,        // the mean square of x, smoothed by a one-pole filter. The envelope is then in the power domain
+    TruePeak,   // the largest |x| of the signal upsampled by TruePeakOversampling
+};
+
+static constexpr size_t TruePeakOversampling = 4;
+static constexpr size_t TruePeakTaps = 8;
+
+// The sum of squares and the largest |x| over every channel of a block, gathered by a kernel while it passes over it
+// Every table adds the samples in the same order, so the meters are as bit-identical as the audio
+struct Meter
+{
+    float sumOfSquares;
+    float peak;
+
+    // The RMS over every sample of every channel, i.e. the root of the mean power rather than the mean channel RMS
+    float getRMS(size_t numValues) const
+    {
+        return numValues > 0 ? std::sqrt(sumOfSquares / static_cast<float>(numValues)) : 0.0f;
+    }
+};
+
+// One crossover of the Crossover lane cascade. See Crossover.h for the lane layout
+struct CrossoverStage
+{
+    // TPT coefficients. k is R2 + g
+    float g, h, R2, k;
+
+    // MaxLanes-padded filter states
+    float* s1;
+    float* s2;
+    float* s3;
+    float* s4;
+
+    // All bits set in the lanes that take the low output of this crossover's split, and in the lanes it filters at all
+    const uint32_t* lowLanes;
+    const uint32_t* activeLanes;
+};
+
+struct CrossoverArgs
+{
+    CrossoverStage* stages;
+    size_t numStages;
+    size_t maxChannels;
+
+    const float* const* input;
+    size_t numChannels;
+    size_t numSamples;
+
+    // The input gain, applied as the input enters the first stage: inputGains[i] for sample i, or inputGain for every
+    // sample when inputGains is nullptr
+    const float* inputGains;
+    float inputGain;
+
+    // outputs[band * maxChannels + channel]
+    float* const* outputs;
+
+    // MaxLanes-padded scratch for the sample being split and the high outputs of a stage
+    float* lanes;
+    float* highs;
+};
+
+struct EnvelopeArgs
+{
+    const float* const* input;
+    float* const* envelope;
+    size_t numChannels;
+    size_t numSamples;
+
+    // One-pole constants of the attack and release followers
+    float attack, release;
+
+    // MaxLanes-padded follower state, one lane per channel
+    float* state;
+
+    Detector detector;
+
+    // RMS: the one-pole constant of the mean square and its MaxLanes-padded state
+    float rmsCoefficient;
+    float* rmsState;
+
+    // TruePeak: TruePeakTaps taps for each of the (TruePeakOversampling - 1) interpolated phases, oldest sample first,
+    // and a history of 2 * TruePeakTaps MaxLanes-padded frames. Every frame is written twice, TruePeakTaps frames
+    // apart, so the last TruePeakTaps frames are always contiguous
+    const float* truePeakTaps;
+    float* truePeakHistory;
+    size_t* truePeakPosition;
+
+    // Written with the levels of the input, and with the largest envelope value of any channel
+    Meter* inputMeter;
+    float* envelopePeak;
+};
+
+struct GainComputerArgs
+{
+    float* const* samples;
+    const float* const* envelope;
+    size_t numChannels;
+    size_t numSamples;
+
+    // The soft knee curve in dB. slope is 1 / ratio - 1, kneeFactor is slope / (2 * knee), or 0 for a hard knee
+    float thresholdDb, halfKneeDb, slope, kneeFactor;
+
+    // Converts log2 of the envelope to dB: 20 log10(2) for an amplitude envelope, 10 log10(2) for a mean square one
+    float log2ToDb;
+
+    // 1 runs the gain computer on every sample. Otherwise it only runs on the last sample of every controlInterval
+    // samples, and the gain is ramped linearly from each of those points to the next through the controlRamp scratch
+    // channels. controlGain is the MaxLanes-padded gain each channel's first ramp starts from, and is written with
+    // the gain of the last sample, whichever the rate
+    size_t controlInterval;
+    float* const* controlRamp;
+    float* controlGain;
+
+    // Written with the levels of the compressed samples
+    Meter* outputMeter;
+};
+
+// One channel of the output: the sum of the bands that are heard, times the output gain
+struct BandSumArgs
+{
+    // The channel of each band that is heard, lowest band first
+    const float* const* bands;
+    size_t numBands;
+    size_t numSamples;
+
+    // gains[i] for sample i, or gain for every sample when gains is nullptr
+    const float* gains;
+    float gain;
+
+    float* destination;
+};
+
+struct Table
+{
+    Isa isa;
+
+    void (*splitBands)(const CrossoverArgs& args);
+    void (*followEnvelope)(const EnvelopeArgs& args);
+
+    // Applies the gain to the samples. Returns the deepest gain reduction in the block in dB
+    float (*computeGain)(const GainComputerArgs& args);
+
+    // Writes the levels of the samples into meter, for blocks that no other kernel passes over
+    void (*measure)(const float* const* samples, size_t numChannels, size_t numSamples, Meter& meter);
+
+    // Overwrites the destination, so it needs no clearing first
+    void (*sumBands)(const BandSumArgs& args);
+};
+
+juce::String getIsaName(Isa isa);
+
+bool isSupported(Isa isa);
+Isa getBestSupportedIsa();
+
+// Only valid for an Isa that isSupported
+const Table& getTable(Isa isa);
+
+// Each translation unit exposes its own table, or nullptr when that instruction set is not built for this target
+namespace Scalar { const Table* getTable(); }
+namespace SSE2 { const Table* getTable(); }
+namespace AVX2 { const Table* getTable(); }
+namespace AVX512 { const Table* getTable(); }
+}
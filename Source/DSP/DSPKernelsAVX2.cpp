@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    DSPKernelsAVX2.cpp
+    Created: 16 Oct 2026 1:18:06pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+/*
+ juce::dsp::SIMDRegister stops at 128 bits, so the AVX2 table uses the GCC/Clang vector extensions instead and
+ compiles only these functions for avx2. The rest of the plugin keeps the baseline target, and the table is
+ only handed out once SystemStats has confirmed the CPU supports it.
+ */
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define SIMPLEMBCOMP_BUILD_AVX2_KERNELS 1
+#else
+ #define SIMPLEMBCOMP_BUILD_AVX2_KERNELS 0
+#endif
+
+#if SIMPLEMBCOMP_BUILD_AVX2_KERNELS
+
+// The scalar and SSE2 tables have no fused multiply-add, so these must not contract into one either or the outputs
+// would stop matching bit for bit
+#if JUCE_CLANG
+ #pragma STDC FP_CONTRACT OFF
+ #pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+ #pragma GCC push_options
+ #pragma GCC optimize("fp-contract=off")
+ #pragma GCC target("avx2")
+#endif
+
+namespace DSPKernels::AVX2
+{
+#include "DSPKernelsImpl.h"
+
+struct Ops
+{
+    typedef float Vec __attribute__((vector_size(32)));
+    typedef int32_t Mask __attribute__((vector_size(32)));
+    static constexpr size_t width = 8;
+
+    static_assert(MaxLanes % width == 0, "Lane buffers must hold a whole number of registers");
+
+    static Vec expand(float x) { return Vec {} + x; }
+    static Vec load(const float* source) { Vec x; std::memcpy(&x, source, sizeof(Vec)); return x; }
+    static void store(float* destination, Vec x) { std::memcpy(destination, &x, sizeof(Vec)); }
+    static Mask loadMask(const uint32_t* source) { Mask mask; std::memcpy(&mask, source, sizeof(Mask)); return mask; }
+    static Mask greaterThan(Vec a, Vec b) { return a > b; }
+    static Vec select(Mask mask, Vec ifTrue, Vec ifFalse) { return (Vec) (((Mask) ifTrue & mask) | ((Mask) ifFalse & ~mask)); }
+    static Vec abs(Vec x) { return (Vec) ((Mask) x & 0x7fffffff); }
+    static Vec max(Vec a, Vec b) { return select(a > b, a, b); }
+    static Vec min(Vec a, Vec b) { return select(a < b, a, b); }
+
+    static Vec exponent(Vec x) { return __builtin_convertvector((((Mask) x) >> 23) - 127, Vec); }
+    static Vec mantissa(Vec x) { return (Vec) ((((Mask) x) & 0x007fffff) | 0x3f800000); }
+    static Vec powerOfTwo(Vec integer) { return (Vec) ((__builtin_convertvector(integer, Mask) + 127) << 23); }
+};
+
+// Instantiated here so the kernels are compiled for avx2 along with Ops
+static void splitBands(const CrossoverArgs& args) { splitBandsImpl<Ops>(args); }
+static void followEnvelope(const EnvelopeArgs& args) { followEnvelopeImpl<Ops>(args); }
+static float computeGain(const GainComputerArgs& args) { return computeGainImpl<Ops>(args); }
+static void measure(const float* const* samples, size_t numChannels, size_t numSamples, Meter& meter) { measureImpl<Ops>(samples, numChannels, numSamples, meter); }
+static void sumBands(const BandSumArgs& args) { sumBandsImpl<Ops>(args); }
+}
+
+#if JUCE_CLANG
+ #pragma clang attribute pop
+#else
+ #pragma GCC pop_options
+#endif
+
+namespace DSPKernels::AVX2
+{
+static const Table table
+{
+    Isa::AVX2,
+    splitBands,
+    followEnvelope,
+    computeGain,
+    measure,
+    sumBands,
+};
+
+const Table* getTable()
+{
+    return &table;
+}
+}
+
+#else
+
+namespace DSPKernels::AVX2
+{
+const Table* getTable()
+{
+    return nullptr;
+}
+}
+
+#endif
@@ -0,0 +1,598 @@
+/*
+  ==============================================================================
+
+    DSPKernelsImpl.h
+    Created: 16 Oct 2026 1:18:06pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+/*
+ The kernel templates shared by every instruction set
+
+ This file is deliberately not include-guarded and has no includes of its own. Each DSPKernels*.cpp includes it
+ inside its own namespace and instantiates the templates with an Ops struct for its register type, so every
+ instruction set gets its own copy of the code compiled for its own target. An Ops struct provides:
+
+     Vec, Mask, width
+     expand, load, store, loadMask, greaterThan, select, abs, max, min
+     exponent, mantissa, powerOfTwo    the float bit fields, see fastLog2 and fastExp2
+
+ Every kernel only ever adds, subtracts and multiplies, in the same order for every width, so all tables produce
+ the same bits as long as no target contracts them into fused multiply-adds. Each DSPKernels*.cpp turns contraction
+ off before it includes this file, and Tools/DSPTests compares every table the CPU supports against the scalar one.
+ */
+
+struct ScalarOps
+{
+    using Vec = float;
+    using Mask = bool;
+    static constexpr size_t width = 1;
+
+    static Vec expand(float x) { return x; }
+    static Vec load(const float* source) { return *source; }
+    static void store(float* destination, Vec x) { *destination = x; }
+    static Mask loadMask(const uint32_t* source) { return *source != 0; }
+    static Mask greaterThan(Vec a, Vec b) { return a > b; }
+    static Vec select(Mask mask, Vec ifTrue, Vec ifFalse) { return mask ? ifTrue : ifFalse; }
+    static Vec abs(Vec x) { return std::abs(x); }
+    static Vec max(Vec a, Vec b) { return a > b ? a : b; }
+    static Vec min(Vec a, Vec b) { return a < b ? a : b; }
+
+    static Vec exponent(Vec x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+    }
+
+    static Vec mantissa(Vec x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    static Vec powerOfTwo(Vec integer)
+    {
+        auto bits = static_cast<uint32_t>(static_cast<int32_t>(integer) + 127) << 23;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+};
+
+// Applies a scalar function to every lane of a register, for the operations no instruction set provides
+template<typename VecOps, typename Function>
+typename VecOps::Vec mapLanes(typename VecOps::Vec x, Function function)
+{
+    alignas(64) float lanes[VecOps::width];
+    VecOps::store(lanes, x);
+    for(size_t lane = 0; lane < VecOps::width; ++lane)
+    {
+        lanes[lane] = function(lanes[lane]);
+    }
+
+    return VecOps::load(lanes);
+}
+
+template<typename VecOps, size_t N>
+typename VecOps::Vec evaluatePolynomial(const float (&coefficients)[N], typename VecOps::Vec x)
+{
+    auto result = VecOps::expand(coefficients[N - 1]);
+    for(size_t i = N - 1; i > 0; --i)
+    {
+        result = result * x + VecOps::expand(coefficients[i - 1]);
+    }
+
+    return result;
+}
+
+// FastMath::log2 on a whole register. Only valid for positive normal lanes
+template<typename VecOps>
+typename VecOps::Vec fastLog2(typename VecOps::Vec x)
+{
+    auto exponent = VecOps::exponent(x);
+    auto mantissa = VecOps::mantissa(x);
+
+    auto isAboveSqrt2 = VecOps::greaterThan(mantissa, VecOps::expand(FastMath::sqrt2));
+    mantissa = VecOps::select(isAboveSqrt2, mantissa * VecOps::expand(0.5f), mantissa);
+    exponent = VecOps::select(isAboveSqrt2, exponent + VecOps::expand(1.0f), exponent);
+
+    auto u = mantissa - VecOps::expand(1.0f);
+    return exponent + u * evaluatePolynomial<VecOps>(FastMath::log2Coefficients, u);
+}
+
+// FastMath::exp2 on a whole register
+template<typename VecOps>
+typename VecOps::Vec fastExp2(typename VecOps::Vec x)
+{
+    x = VecOps::min(VecOps::max(x, VecOps::expand(-126.0f)), VecOps::expand(126.0f));
+
+    auto integer = (x + VecOps::expand(FastMath::roundingMagic)) - VecOps::expand(FastMath::roundingMagic);
+    auto fraction = x - integer;
+
+    return VecOps::powerOfTwo(integer) * (VecOps::expand(1.0f) + fraction * evaluatePolynomial<VecOps>(FastMath::exp2Coefficients, fraction));
+}
+
+template<typename VecOps>
+void processCrossoverStage(const CrossoverStage& stage, size_t numActiveLanes, float* lanes, float* highs)
+{
+    const auto g = VecOps::expand(stage.g);
+    const auto h = VecOps::expand(stage.h);
+    const auto R2 = VecOps::expand(stage.R2);
+    const auto k = VecOps::expand(stage.k);
+
+    // Lanes past numActiveLanes in the last register are filtered too, but masked back to their input
+    for(size_t offset = 0; offset < numActiveLanes; offset += VecOps::width)
+    {
+        auto x = VecOps::load(lanes + offset);
+        auto s1 = VecOps::load(stage.s1 + offset);
+        auto s2 = VecOps::load(stage.s2 + offset);
+        auto s3 = VecOps::load(stage.s3 + offset);
+        auto s4 = VecOps::load(stage.s4 + offset);
+
+        // First section. Its outputs sum to the allpass response used by the bands below the crossover
+        auto yH = (x - k * s1 - s2) * h;
+        auto yB = g * yH + s1;
+        s1 = g * yH + yB;
+        auto yL = g * yB + s2;
+        s2 = g * yB + yL;
+        auto allpass = yL - R2 * yB + yH;
+
+        // Second section turns the low output into the fourth order low-pass. The high-pass is the allpass minus the low-pass
+        auto yH2 = (yL - k * s3 - s4) * h;
+        auto yB2 = g * yH2 + s3;
+        s3 = g * yH2 + yB2;
+        auto yL2 = g * yB2 + s4;
+        s4 = g * yB2 + yL2;
+
+        // Padding lanes keep their input so the slots above this crossover are left as they were
+        auto lowMask = VecOps::loadMask(stage.lowLanes + offset);
+        auto activeMask = VecOps::loadMask(stage.activeLanes + offset);
+        auto result = VecOps::select(activeMask, VecOps::select(lowMask, yL2, allpass), x);
+
+        VecOps::store(lanes + offset, result);
+        VecOps::store(highs + offset, allpass - yL2);
+
+        VecOps::store(stage.s1 + offset, s1);
+        VecOps::store(stage.s2 + offset, s2);
+        VecOps::store(stage.s3 + offset, s3);
+        VecOps::store(stage.s4 + offset, s4);
+    }
+}
+
+template<typename VecOps>
+void splitBandsImpl(const CrossoverArgs& args)
+{
+    const auto maxChannels = args.maxChannels;
+    const auto numBands = args.numStages + 1;
+
+    for(size_t i = 0; i < args.numSamples; ++i)
+    {
+        // The whole input starts out as the remainder in slot 0, with the input gain applied on the way in
+        const auto inputGain = args.inputGains != nullptr ? args.inputGains[i] : args.inputGain;
+        for(size_t channel = 0; channel < args.numChannels; ++channel)
+        {
+            args.lanes[channel] = args.input[channel][i] * inputGain;
+        }
+
+        for(size_t crossover = 0; crossover < args.numStages; ++crossover)
+        {
+            // Crossover c filters the lanes of slots 0 to c, which all share its cutoff
+            processCrossoverStage<VecOps>(args.stages[crossover], (crossover + 1) * maxChannels, args.lanes, args.highs);
+
+            // The high output of the split becomes the remainder in the next slot up. The lanes of channels the block
+            // does not have are left as Crossover::process cleared them
+            for(size_t channel = 0; channel < args.numChannels; ++channel)
+            {
+                args.lanes[(crossover + 1) * maxChannels + channel] = args.highs[crossover * maxChannels + channel];
+            }
+        }
+
+        for(size_t band = 0; band < numBands; ++band)
+        {
+            for(size_t channel = 0; channel < args.numChannels; ++channel)
+            {
+                args.outputs[band * maxChannels + channel][i] = args.lanes[band * maxChannels + channel];
+            }
+        }
+    }
+}
+
+template<typename VecOps, Detector detector>
+void followEnvelopeLoop(const EnvelopeArgs& args)
+{
+    // Every channel's follower advances side by side, one lane per channel
+    const auto attack = VecOps::expand(args.attack);
+    const auto release = VecOps::expand(args.release);
+    const auto rmsCoefficient = VecOps::expand(args.rmsCoefficient);
+
+    alignas(64) float frame[MaxLanes] = {};
+    alignas(64) float followers[MaxLanes] = {};
+
+    // The input meter also runs one lane per channel, so each channel's samples are summed in order on every width
+    alignas(64) float squares[MaxLanes] = {};
+    alignas(64) float peaks[MaxLanes] = {};
+    alignas(64) float envelopePeaks[MaxLanes] = {};
+
+    auto position = args.truePeakPosition != nullptr ? *args.truePeakPosition : 0;
+
+    for(size_t i = 0; i < args.numSamples; ++i)
+    {
+        for(size_t channel = 0; channel < args.numChannels; ++channel)
+        {
+            frame[channel] = args.input[channel][i];
+        }
+
+        if constexpr(detector == Detector::TruePeak)
+            position = (position + 1) % TruePeakTaps;
+
+        for(size_t offset = 0; offset < args.numChannels; offset += VecOps::width)
+        {
+            auto x = VecOps::load(frame + offset);
+            auto level = VecOps::abs(x);
+
+            VecOps::store(squares + offset, VecOps::load(squares + offset) + x * x);
+            VecOps::store(peaks + offset, VecOps::max(VecOps::load(peaks + offset), level));
+
+            if constexpr(detector == Detector::RMS)
+            {
+                auto square = x * x;
+                auto meanSquare = VecOps::load(args.rmsState + offset);
+                level = square + rmsCoefficient * (meanSquare - square);
+                VecOps::store(args.rmsState + offset, level);
+            }
+            else if constexpr(detector == Detector::TruePeak)
+            {
+                auto* history = args.truePeakHistory + offset;
+                VecOps::store(history + position * MaxLanes, x);
+                VecOps::store(history + (position + TruePeakTaps) * MaxLanes, x);
+
+                // The window is the last TruePeakTaps frames, oldest first. Its centre sample is the phase that
+                // needs no interpolation, so the detector runs TruePeakTaps / 2 samples behind the input
+                const auto* window = history + (position + 1) * MaxLanes;
+                level = VecOps::abs(VecOps::load(window + (TruePeakTaps / 2 - 1) * MaxLanes));
+
+                for(size_t phase = 0; phase < TruePeakOversampling - 1; ++phase)
+                {
+                    const auto* taps = args.truePeakTaps + phase * TruePeakTaps;
+                    auto interpolated = VecOps::expand(taps[0]) * VecOps::load(window);
+                    for(size_t tap = 1; tap < TruePeakTaps; ++tap)
+                    {
+                        interpolated = interpolated + VecOps::expand(taps[tap]) * VecOps::load(window + tap * MaxLanes);
+                    }
+
+                    level = VecOps::max(level, VecOps::abs(interpolated));
+                }
+            }
+
+            // Branch-free choice of the attack or release constant
+            auto y = VecOps::load(args.state + offset);
+            auto cte = VecOps::select(VecOps::greaterThan(level, y), attack, release);
+            y = level + cte * (y - level);
+
+            VecOps::store(args.state + offset, y);
+            VecOps::store(followers + offset, y);
+            VecOps::store(envelopePeaks + offset, VecOps::max(VecOps::load(envelopePeaks + offset), y));
+        }
+
+        for(size_t channel = 0; channel < args.numChannels; ++channel)
+        {
+            args.envelope[channel][i] = followers[channel];
+        }
+    }
+
+    if(args.truePeakPosition != nullptr)
+        *args.truePeakPosition = position;
+
+    *args.inputMeter = {0.0f, 0.0f};
+    *args.envelopePeak = 0.0f;
+    for(size_t channel = 0; channel < args.numChannels; ++channel)
+    {
+        args.inputMeter -> sumOfSquares += squares[channel];
+        args.inputMeter -> peak = std::max(args.inputMeter -> peak, peaks[channel]);
+        *args.envelopePeak = std::max(*args.envelopePeak, envelopePeaks[channel]);
+    }
+}
+
+template<typename VecOps>
+void followEnvelopeImpl(const EnvelopeArgs& args)
+{
+    switch(args.detector)
+    {
+        case Detector::Peak: followEnvelopeLoop<VecOps, Detector::Peak>(args); break;
+        case Detector::RMS: followEnvelopeLoop<VecOps, Detector::RMS>(args); break;
+        case Detector::TruePeak: followEnvelopeLoop<VecOps, Detector::TruePeak>(args); break;
+    }
+}
+
+template<typename VecOps>
+struct GainComputer
+{
+    using Vec = typename VecOps::Vec;
+
+    explicit GainComputer(const GainComputerArgs& args)
+        : thresholdDb(VecOps::expand(args.thresholdDb)),
+          halfKneeDb(VecOps::expand(args.halfKneeDb)),
+          slope(VecOps::expand(args.slope)),
+          kneeFactor(VecOps::expand(args.kneeFactor)),
+          log2ToDb(VecOps::expand(args.log2ToDb)),
+          deepest(VecOps::expand(0))
+    {
+    }
+
+    // Returns the gain reduction in dB for a register of envelope values, and keeps track of the deepest one
+    Vec process(Vec level)
+    {
+        // The floor keeps log2 finite on silence, far below any threshold
+        auto overDb = log2ToDb * fastLog2<VecOps>(VecOps::max(level, VecOps::expand(1.0e-20f))) - thresholdDb;
+
+        // Above the knee the curve is a straight line. Inside it the quadratic meets that line and the unity gain
+        // line smoothly, and below it the clamp makes the quadratic zero
+        auto kneeDb = VecOps::max(overDb + halfKneeDb, VecOps::expand(0));
+        auto reductionDb = VecOps::select(VecOps::greaterThan(overDb, halfKneeDb), slope * overDb, kneeFactor * kneeDb * kneeDb);
+
+        deepest = VecOps::min(deepest, reductionDb);
+        return reductionDb;
+    }
+
+    Vec thresholdDb, halfKneeDb, slope, kneeFactor, log2ToDb, deepest;
+};
+
+/*
+ The meter of one channel that a kernel runs over in whole registers
+
+ Sample i is added to partial sum i % MaxLanes, and the partial sums are only added together at the end, so every
+ register width adds the same samples in the same order.
+ */
+template<typename VecOps>
+struct ChannelMeter
+{
+    using Vec = typename VecOps::Vec;
+
+    static constexpr size_t numRegisters = MaxLanes / VecOps::width;
+
+    ChannelMeter()
+    {
+        for(auto& partial : squares)
+        {
+            partial = VecOps::expand(0);
+        }
+    }
+
+    // Register reg of the current group of MaxLanes samples
+    void add(size_t reg, Vec x)
+    {
+        squares[reg] = squares[reg] + x * x;
+        peak = VecOps::max(peak, VecOps::abs(x));
+    }
+
+    // Adds the samples from tailStart on one at a time, then adds the channel's totals to meter
+    void finish(const float* samples, size_t tailStart, size_t numSamples, Meter& meter)
+    {
+        alignas(64) float partials[MaxLanes];
+        alignas(64) float peaks[VecOps::width];
+        for(size_t reg = 0; reg < numRegisters; ++reg)
+        {
+            VecOps::store(partials + reg * VecOps::width, squares[reg]);
+        }
+
+        VecOps::store(peaks, peak);
+
+        for(size_t i = tailStart; i < numSamples; ++i)
+        {
+            partials[i % MaxLanes] += samples[i] * samples[i];
+            meter.peak = std::max(meter.peak, std::abs(samples[i]));
+        }
+
+        auto sum = 0.0f;
+        for(auto partial : partials)
+        {
+            sum += partial;
+        }
+
+        meter.sumOfSquares += sum;
+        for(auto lanePeak : peaks)
+        {
+            meter.peak = std::max(meter.peak, lanePeak);
+        }
+    }
+
+    Vec squares[numRegisters];
+    Vec peak {VecOps::expand(0)};
+};
+
+// Calls body(i, reg) for every whole register of a channel, reg being its ChannelMeter register. Returns where the
+// samples that do not fill a register start
+template<typename VecOps, typename Body>
+size_t forEachRegister(size_t numSamples, Body&& body)
+{
+    size_t i = 0;
+
+    // Whole groups of MaxLanes samples, so the ChannelMeter registers can stay in registers
+    for(; i + MaxLanes <= numSamples; i += MaxLanes)
+    {
+        for(size_t reg = 0; reg < ChannelMeter<VecOps>::numRegisters; ++reg)
+        {
+            body(i + reg * VecOps::width, reg);
+        }
+    }
+
+    for(size_t reg = 0; i + VecOps::width <= numSamples; i += VecOps::width, ++reg)
+    {
+        body(i, reg);
+    }
+
+    return i;
+}
+
+/*
+ The gain computer at control rate
+
+ Each channel is cut into segments of controlInterval samples from the start of the block, the last one possibly
+ shorter. The gain computer runs on the envelope of the last sample of each segment, and the linear gain ramps from
+ the end of the segment before to that point. Working out the ramps is plain scalar arithmetic on one value per
+ sample, so every width writes the same gains, and only the multiply and the meter run in whole registers.
+ */
+template<typename VecOps>
+float computeControlRateGainImpl(const GainComputerArgs& args)
+{
+    GainComputer<ScalarOps> computer(args);
+
+    *args.outputMeter = {0.0f, 0.0f};
+
+    for(size_t channel = 0; channel < args.numChannels; ++channel)
+    {
+        auto* samples = args.samples[channel];
+        const auto* envelope = args.envelope[channel];
+        auto* ramp = args.controlRamp[channel];
+        auto gain = args.controlGain[channel];
+
+        for(size_t start = 0; start < args.numSamples; start += args.controlInterval)
+        {
+            auto length = std::min(args.controlInterval, args.numSamples - start);
+            auto reductionDb = computer.process(envelope[start + length - 1]);
+            auto target = fastExp2<ScalarOps>(reductionDb * FastMath::decibelsToLog2);
+            auto step = (target - gain) / static_cast<float>(length);
+
+            for(size_t i = 0; i < length; ++i)
+            {
+                ramp[start + i] = gain + step * static_cast<float>(i + 1);
+            }
+
+            // The next ramp starts from the gain the computer gave, rather than from where this one rounded to
+            gain = target;
+        }
+
+        args.controlGain[channel] = gain;
+
+        ChannelMeter<VecOps> meter;
+
+        auto tailStart = forEachRegister<VecOps>(args.numSamples, [&](size_t i, size_t reg)
+        {
+            auto y = VecOps::load(samples + i) * VecOps::load(ramp + i);
+            VecOps::store(samples + i, y);
+            meter.add(reg, y);
+        });
+
+        for(auto i = tailStart; i < args.numSamples; ++i)
+        {
+            samples[i] *= ramp[i];
+        }
+
+        meter.finish(samples, tailStart, args.numSamples, *args.outputMeter);
+    }
+
+    return computer.deepest;
+}
+
+template<typename VecOps>
+float computeGainImpl(const GainComputerArgs& args)
+{
+    if(args.controlInterval > 1)
+        return computeControlRateGainImpl<VecOps>(args);
+
+    const auto dbToLog2 = VecOps::expand(FastMath::decibelsToLog2);
+
+    GainComputer<VecOps> computer(args);
+    GainComputer<ScalarOps> tailComputer(args);
+
+    *args.outputMeter = {0.0f, 0.0f};
+
+    // The gain computer has no state, so each channel is a straight loop over the envelope
+    for(size_t channel = 0; channel < args.numChannels; ++channel)
+    {
+        auto* samples = args.samples[channel];
+        const auto* envelope = args.envelope[channel];
+
+        // The output is metered while it is still in registers
+        ChannelMeter<VecOps> meter;
+
+        auto tailStart = forEachRegister<VecOps>(args.numSamples, [&](size_t i, size_t reg)
+        {
+            auto reductionDb = computer.process(VecOps::load(envelope + i));
+
+            auto y = VecOps::load(samples + i) * fastExp2<VecOps>(reductionDb * dbToLog2);
+            VecOps::store(samples + i, y);
+            meter.add(reg, y);
+        });
+
+        for(auto i = tailStart; i < args.numSamples; ++i)
+        {
+            auto reductionDb = tailComputer.process(envelope[i]);
+            samples[i] *= fastExp2<ScalarOps>(reductionDb * FastMath::decibelsToLog2);
+        }
+
+        meter.finish(samples, tailStart, args.numSamples, *args.outputMeter);
+
+        // Where a switch to control rate starts ramping from. Every width computes the same reduction for a sample, so
+        // working the last one out again gives the gain it was given, and leaves the deepest reduction as it was
+        if(args.numSamples > 0)
+            args.controlGain[channel] = fastExp2<ScalarOps>(tailComputer.process(envelope[args.numSamples - 1]) * FastMath::decibelsToLog2);
+    }
+
+    alignas(64) float deepest[VecOps::width];
+    VecOps::store(deepest, computer.deepest);
+
+    auto result = tailComputer.deepest;
+    for(auto reductionDb : deepest)
+    {
+        result = std::min(result, reductionDb);
+    }
+
+    return result;
+}
+
+template<typename VecOps>
+void measureImpl(const float* const* samples, size_t numChannels, size_t numSamples, Meter& meter)
+{
+    meter = {0.0f, 0.0f};
+
+    for(size_t channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* channelSamples = samples[channel];
+
+        ChannelMeter<VecOps> channelMeter;
+        auto tailStart = forEachRegister<VecOps>(numSamples, [&](size_t i, size_t reg)
+        {
+            channelMeter.add(reg, VecOps::load(channelSamples + i));
+        });
+
+        channelMeter.finish(channelSamples, tailStart, numSamples, meter);
+    }
+}
+
+template<typename VecOps>
+void sumBandsImpl(const BandSumArgs& args)
+{
+    const auto constantGain = VecOps::expand(args.gain);
+
+    // The sum starts from 0, so no band at all is silence and the bits match adding the bands into a cleared buffer
+    size_t i = 0;
+    for(; i + VecOps::width <= args.numSamples; i += VecOps::width)
+    {
+        auto sum = VecOps::expand(0);
+        for(size_t band = 0; band < args.numBands; ++band)
+        {
+            sum = sum + VecOps::load(args.bands[band] + i);
+        }
+
+        auto gain = args.gains != nullptr ? VecOps::load(args.gains + i) : constantGain;
+        VecOps::store(args.destination + i, sum * gain);
+    }
+
+    for(; i < args.numSamples; ++i)
+    {
+        auto sum = 0.0f;
+        for(size_t band = 0; band < args.numBands; ++band)
+        {
+            sum += args.bands[band][i];
+        }
+
+        args.destination[i] = sum * (args.gains != nullptr ? args.gains[i] : args.gain);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    DSPKernelsSSE2.cpp
+    Created: 16 Oct 2026 1:18:06pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+#include "SIMDHelpers.h"
+
+// NEON has fused multiply-adds, so ARM compilers would contract these loops into them unless told not to, and the
+// outputs would stop matching the scalar table bit for bit
+#if JUCE_CLANG
+ #pragma STDC FP_CONTRACT OFF
+#elif JUCE_GCC
+ #pragma GCC optimize("fp-contract=off")
+#elif JUCE_MSVC
+ #pragma fp_contract(off)
+#endif
+
+namespace DSPKernels::SSE2
+{
+#include "DSPKernelsImpl.h"
+
+// juce::dsp::SIMDRegister is the baseline register of the target, SSE2 on Intel and NEON on ARM
+struct Ops
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    using Mask = Vec::vMaskType;
+    static constexpr size_t width = Vec::SIMDNumElements;
+
+    static_assert(MaxLanes % width == 0, "Lane buffers must hold a whole number of registers");
+
+    static Vec expand(float x) { return Vec::expand(x); }
+    static Vec load(const float* source) { return SIMDHelpers::load<Vec>(source); }
+    static void store(float* destination, Vec x) { SIMDHelpers::store(destination, x); }
+    static Mask loadMask(const uint32_t* source) { return SIMDHelpers::loadMask<Vec>(source); }
+    static Mask greaterThan(Vec a, Vec b) { return Vec::greaterThan(a, b); }
+    static Vec select(Mask mask, Vec ifTrue, Vec ifFalse) { return SIMDHelpers::select(mask, ifTrue, ifFalse); }
+    static Vec abs(Vec x) { return SIMDHelpers::abs(x); }
+    static Vec max(Vec a, Vec b) { return Vec::max(a, b); }
+    static Vec min(Vec a, Vec b) { return Vec::min(a, b); }
+
+    // SIMDRegister has no integer conversions or shifts, so the bit fields use the native register
+   #if JUCE_INTEL
+    static Vec exponent(Vec x)
+    {
+        auto bits = _mm_srli_epi32(_mm_castps_si128(x.value), 23);
+        return Vec::fromNative(_mm_cvtepi32_ps(_mm_sub_epi32(bits, _mm_set1_epi32(127))));
+    }
+
+    static Vec mantissa(Vec x)
+    {
+        auto bits = _mm_and_si128(_mm_castps_si128(x.value), _mm_set1_epi32(0x007fffff));
+        return Vec::fromNative(_mm_castsi128_ps(_mm_or_si128(bits, _mm_set1_epi32(0x3f800000))));
+    }
+
+    static Vec powerOfTwo(Vec integer)
+    {
+        auto bits = _mm_add_epi32(_mm_cvtps_epi32(integer.value), _mm_set1_epi32(127));
+        return Vec::fromNative(_mm_castsi128_ps(_mm_slli_epi32(bits, 23)));
+    }
+   #elif JUCE_ARM
+    static Vec exponent(Vec x)
+    {
+        auto bits = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(x.value), 23));
+        return Vec::fromNative(vcvtq_f32_s32(vsubq_s32(bits, vdupq_n_s32(127))));
+    }
+
+    static Vec mantissa(Vec x)
+    {
+        auto bits = vandq_u32(vreinterpretq_u32_f32(x.value), vdupq_n_u32(0x007fffff));
+        return Vec::fromNative(vreinterpretq_f32_u32(vorrq_u32(bits, vdupq_n_u32(0x3f800000))));
+    }
+
+    static Vec powerOfTwo(Vec integer)
+    {
+        auto bits = vaddq_s32(vcvtq_s32_f32(integer.value), vdupq_n_s32(127));
+        return Vec::fromNative(vreinterpretq_f32_s32(vshlq_n_s32(bits, 23)));
+    }
+   #else
+    static Vec exponent(Vec x) { return mapLanes<Ops>(x, ScalarOps::exponent); }
+    static Vec mantissa(Vec x) { return mapLanes<Ops>(x, ScalarOps::mantissa); }
+    static Vec powerOfTwo(Vec integer) { return mapLanes<Ops>(integer, ScalarOps::powerOfTwo); }
+   #endif
+};
+
+static const Table table
+{
+    Isa::SSE2,
+    splitBandsImpl<Ops>,
+    followEnvelopeImpl<Ops>,
+    computeGainImpl<Ops>,
+    measureImpl<Ops>,
+    sumBandsImpl<Ops>,
+};
+
+const Table* getTable()
+{
+    return &table;
+}
+}
@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    DSPKernelsScalar.cpp
+    Created: 16 Oct 2026 1:18:06pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+// The reference has to round every multiply and add on its own, whatever the target's default contraction is
+#if JUCE_CLANG
+ #pragma STDC FP_CONTRACT OFF
+#elif JUCE_GCC
+ #pragma GCC optimize("fp-contract=off")
+#elif JUCE_MSVC
+ #pragma fp_contract(off)
+#endif
+
+namespace DSPKernels::Scalar
+{
+#include "DSPKernelsImpl.h"
+
+// The reference every other table is compared against, one lane at a time with no vector registers
+static const Table table
+{
+    Isa::Scalar,
+    splitBandsImpl<ScalarOps>,
+    followEnvelopeImpl<ScalarOps>,
+    computeGainImpl<ScalarOps>,
+    measureImpl<ScalarOps>,
+    sumBandsImpl<ScalarOps>,
+};
+
+const Table* getTable()
+{
+    return &table;
+}
+}
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    DeadlineMonitor.cpp
+    Created: 16 Oct 2026 9:46:33pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "DeadlineMonitor.h"
+
+void DeadlineMonitor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    resetRequested = false;
+    clear();
+}
+
+void DeadlineMonitor::clear() noexcept
+{
+    numBlocks.store(0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    numOverrunsWithParameterChanges.store(0, std::memory_order_relaxed);
+    maxLoad.store(0.0, std::memory_order_relaxed);
+    maxSeconds.store(0.0, std::memory_order_relaxed);
+
+    for(auto& count : histogram){
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void DeadlineMonitor::record(juce::int64 elapsedTicks, int numSamples, bool parametersChanged) noexcept
+{
+    if(sampleRate <= 0.0 || numSamples <= 0){
+        return;
+    }
+
+    if(resetRequested.exchange(false, std::memory_order_relaxed)){
+        clear();
+    }
+
+    // The audio thread is the only writer, so a load and a store do what an atomic increment would
+    auto increment = [](std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    };
+
+    const auto seconds = static_cast<double>(elapsedTicks) * secondsPerTick;
+    const auto load = seconds * sampleRate / numSamples;
+
+    increment(numBlocks);
+    const auto bucket = juce::jlimit(0.0, static_cast<double>(NumBuckets - 1), load * 100.0 * bucketsPerPercent);
+    increment(histogram[static_cast<size_t>(bucket)]);
+
+    if(load > 1.0){
+        increment(numOverruns);
+        if(parametersChanged){
+            increment(numOverrunsWithParameterChanges);
+        }
+    }
+
+    if(load > maxLoad.load(std::memory_order_relaxed)){
+        maxLoad.store(load, std::memory_order_relaxed);
+    }
+    if(seconds > maxSeconds.load(std::memory_order_relaxed)){
+        maxSeconds.store(seconds, std::memory_order_relaxed);
+    }
+}
+
+DeadlineMonitor::Report DeadlineMonitor::getReport() const
+{
+    Report report;
+    report.numOverruns = numOverruns.load(std::memory_order_relaxed);
+    report.numOverrunsWithParameterChanges = numOverrunsWithParameterChanges.load(std::memory_order_relaxed);
+    report.max = maxLoad.load(std::memory_order_relaxed);
+    report.maxMicroseconds = maxSeconds.load(std::memory_order_relaxed) * 1.0e6;
+
+    // The block count is taken from the histogram itself, so the percentiles agree with it even mid-block
+    for(size_t bucket = 0; bucket < NumBuckets; ++bucket){
+        report.histogram[bucket] = histogram[bucket].load(std::memory_order_relaxed);
+        report.numBlocks += report.histogram[bucket];
+    }
+
+    auto getPercentile = [&report](double fraction)
+    {
+        const auto rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(report.numBlocks)));
+        uint64_t count = 0;
+
+        for(size_t bucket = 0; bucket < NumBuckets - 1; ++bucket){
+            count += report.histogram[bucket];
+            if(count >= rank){
+                return juce::jmin(static_cast<double>(bucket + 1) / (100.0 * bucketsPerPercent), report.max);
+            }
+        }
+
+        // Past the last bucket only the maximum is known
+        return report.max;
+    };
+
+    if(report.numBlocks > 0){
+        report.p50 = getPercentile(0.5);
+        report.p99 = getPercentile(0.99);
+        report.p999 = getPercentile(0.999);
+    }
+
+    return report;
+}
+
+juce::String DeadlineMonitor::Report::toString() const
+{
+    auto percent = [](double load) { return juce::String(load * 100.0, 2) + "%"; };
+
+    juce::String text;
+    text << "SimpleMBComp deadline report, " << juce::Time::getCurrentTime().toString(true, true) << "\n"
+         << "Blocks: " << juce::String(numBlocks) << "\n"
+         << "Overruns: " << juce::String(numOverruns) << ", " << juce::String(numOverrunsWithParameterChanges)
+         << " of them in blocks with parameter changes\n"
+         << "Load p50: " << percent(p50) << "\n"
+         << "Load p99: " << percent(p99) << "\n"
+         << "Load p99.9: " << percent(p999) << "\n"
+         << "Load max: " << percent(max) << " (" << juce::String(maxMicroseconds, 1) << " us)\n"
+         << "\n"
+         << "Load from (%), blocks\n";
+
+    for(size_t bucket = 0; bucket < NumBuckets; ++bucket){
+        if(histogram[bucket] > 0){
+            text << juce::String(static_cast<double>(bucket) / bucketsPerPercent, 1) << ", " << juce::String(histogram[bucket]) << "\n";
+        }
+    }
+
+    return text;
+}
+
+bool DeadlineMonitor::writeReport(const juce::File& file) const
+{
+    return file.replaceWithText(getReport().toString());
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    DeadlineMonitor.h
+    Created: 16 Oct 2026 9:46:33pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+ Compares the wall time of every processBlock with the block's real-time budget, numSamples / sampleRate
+
+ Each block's load, its time as a share of the budget, goes into a histogram in steps of 0.1%. A block that takes longer
+ than its budget is an overrun, and the overruns of blocks that had parameter changes to pass on are counted
+ separately, since a crossover change recomputes every filter in that block. Averages hide exactly those spikes, so
+ the report gives the percentiles and the maximum instead. Only the audio thread writes the counters. Anything else
+ reads them without a lock, and a reset asked for by the GUI is carried out by the audio thread on its next block.
+ */
+class DeadlineMonitor
+{
+public:
+    // Bucket i holds the blocks with a load in [i / 10 %, (i + 1) / 10 %). The last one takes everything from
+    // maxLoadPercent up
+    static constexpr int bucketsPerPercent = 10;
+    static constexpr int maxLoadPercent = 200;
+    static constexpr size_t NumBuckets = maxLoadPercent * bucketsPerPercent + 1;
+
+    struct Report
+    {
+        uint64_t numBlocks = 0;
+        uint64_t numOverruns = 0;
+        uint64_t numOverrunsWithParameterChanges = 0;
+
+        // Loads as fractions of the budget. The percentiles are the upper edge of their bucket, the maximum is exact
+        double p50 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0;
+        double maxMicroseconds = 0.0;
+
+        std::array<uint64_t, NumBuckets> histogram {};
+
+        juce::String toString() const;
+    };
+
+    // Not real-time safe. Clears the counters
+    void prepare(double sampleRate);
+
+    // Asks the audio thread to clear the counters before it records its next block
+    void requestReset() { resetRequested = true; }
+
+    // Times one processBlock from construction to destruction
+    class Scope
+    {
+    public:
+        Scope(DeadlineMonitor& monitor, int numSamples) noexcept
+            : monitor(monitor), numSamples(numSamples), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~Scope() noexcept { monitor.record(juce::Time::getHighResolutionTicks() - start, numSamples, parametersChanged); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // Set when the block passed parameter changes on to the DSP
+        bool parametersChanged = false;
+
+    private:
+        DeadlineMonitor& monitor;
+        int numSamples;
+        juce::int64 start;
+    };
+
+    Report getReport() const;
+
+    // Writes getReport().toString(). Returns false if the file could not be written
+    bool writeReport(const juce::File& file) const;
+
+private:
+    double secondsPerTick = 1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    double sampleRate = 0.0;
+
+    std::atomic<bool> resetRequested {false};
+
+    std::atomic<uint64_t> numBlocks {0};
+    std::atomic<uint64_t> numOverruns {0};
+    std::atomic<uint64_t> numOverrunsWithParameterChanges {0};
+    std::atomic<double> maxLoad {0.0};
+    std::atomic<double> maxSeconds {0.0};
+    std::array<std::atomic<uint64_t>, NumBuckets> histogram {};
+
+    void record(juce::int64 elapsedTicks, int numSamples, bool parametersChanged) noexcept;
+    void clear() noexcept;
+};
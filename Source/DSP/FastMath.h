@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 16 Oct 2026 3:21:48pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+ Polynomial log2/exp2 and the dB conversions built on them
+
+ Both split the argument into a power of two, handled by the float's exponent bits, and a reduced argument
+ that a minimax polynomial covers. The polynomials are written so that log2(1) and exp2(0) are exact, which
+ keeps unity gain bit transparent. Measured against the double precision std functions, and checked by the
+ FastMath tests in Tools/DSPTests:
+
+     log2(x)               |error| < 8e-7 for x in [0.5, 2), < 2e-6 for x in [1e-6, 16], < 5e-6 for any positive normal x
+     exp2(x)               relative error < 1e-7 for x in [-126, 126], clamped outside
+     gainToDecibels(g)     |error| < 2e-5 dB for g in [1e-6, 16], < 7e-5 dB for any positive normal g
+     decibelsToGain(dB)    relative error < 8e-7 for dB in [-100, 40]
+
+ Away from 1 the bounds are set by rounding the result to a float rather than by the polynomials.
+
+ The compressor kernels evaluate the same polynomials on whole registers (see fastLog2/fastExp2 in
+ DSPKernelsImpl.h), in the same order, so the scalar and vector results are identical.
+ */
+namespace FastMath
+{
+
+// log2(1 + u) = u * P(u) for u = m - 1, m in [sqrt(1/2), sqrt(2)). Lowest order first
+static constexpr float log2Coefficients[] =
+{
+    1.442696306690625f, -0.7213676938336022f, 0.48064870474650395f, -0.3591847929247759f,
+    0.2950997350253661f, -0.27097751154381694f, 0.17616723535489728f,
+};
+
+// 2^f = 1 + f * P(f) for f in [-0.5, 0.5]. Lowest order first
+static constexpr float exp2Coefficients[] =
+{
+    0.6931471880289379f, 0.2402265108421489f, 0.055503571055382596f,
+    0.00961803077054079f, 0.0013390866840636752f, 0.00015469735202131393f,
+};
+
+static constexpr float sqrt2 = 1.41421356237309504880f;
+
+// Adding and subtracting 1.5 * 2^23 rounds a float to the nearest integer without leaving the float registers
+static constexpr float roundingMagic = 12582912.0f;
+
+// 20 log10(2), and its inverse
+static constexpr float log2ToDecibels = 6.020599913279624f;
+static constexpr float decibelsToLog2 = 0.16609640474436813f;
+
+template<size_t N>
+inline float evaluatePolynomial(const float (&coefficients)[N], float x)
+{
+    auto result = coefficients[N - 1];
+    for(size_t i = N - 1; i > 0; --i)
+    {
+        result = result * x + coefficients[i - 1];
+    }
+
+    return result;
+}
+
+inline float log2(float x)
+{
+    // x = 2^exponent * mantissa with the mantissa in [1, 2)
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    auto exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // Centring the mantissa on 1 halves the range the polynomial has to cover
+    if(mantissa > sqrt2)
+    {
+        mantissa = mantissa * 0.5f;
+        exponent = exponent + 1.0f;
+    }
+
+    auto u = mantissa - 1.0f;
+    return exponent + u * evaluatePolynomial(log2Coefficients, u);
+}
+
+inline float exp2(float x)
+{
+    x = juce::jlimit(-126.0f, 126.0f, x);
+
+    auto integer = (x + roundingMagic) - roundingMagic;
+    auto fraction = x - integer;
+
+    auto bits = static_cast<uint32_t>(static_cast<int32_t>(integer) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+
+    return scale * (1.0f + fraction * evaluatePolynomial(exp2Coefficients, fraction));
+}
+
+// The same results as juce::Decibels within the bounds above
+inline float gainToDecibels(float gain, float minusInfinityDb = -100.0f)
+{
+    return gain > 0.0f ? juce::jmax(minusInfinityDb, log2(gain) * log2ToDecibels) : minusInfinityDb;
+}
+
+inline float decibelsToGain(float decibels, float minusInfinityDb = -100.0f)
+{
+    return decibels > minusInfinityDb ? exp2(decibels * decibelsToLog2) : 0.0f;
+}
+
+/*
+ The one-pole coefficients of every whole millisecond of the attack/release parameter range
+
+ The parameters move in 1 ms steps, so after prepare a coefficient is a lookup rather than a call to std::exp.
+ Times that fall between the steps or outside the range still get the exact value.
+ */
+struct EnvelopeCoefficientTable
+{
+    static constexpr int MinTimeMs = 5;
+    static constexpr int MaxTimeMs = 500;
+
+    EnvelopeCoefficientTable()
+    {
+        prepare(sampleRate);
+    }
+
+    // Not real-time safe. Fills the table for a new sample rate
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        for(int timeMs = MinTimeMs; timeMs <= MaxTimeMs; ++timeMs)
+        {
+            coefficients[static_cast<size_t>(timeMs - MinTimeMs)] = calculate(static_cast<float>(timeMs));
+        }
+    }
+
+    float get(float timeMs) const
+    {
+        auto index = static_cast<int>(timeMs) - MinTimeMs;
+        if(static_cast<float>(static_cast<int>(timeMs)) == timeMs && index >= 0 && index <= MaxTimeMs - MinTimeMs)
+            return coefficients[static_cast<size_t>(index)];
+
+        return calculate(timeMs);
+    }
+
+private:
+    float calculate(float timeMs) const
+    {
+        // The same one-pole time constant as juce::dsp::BallisticsFilter
+        auto expFactor = -2.0 * juce::MathConstants<double>::pi * 1000.0 / sampleRate;
+        return timeMs < 1.0e-3f ? 0.0f : static_cast<float>(std::exp(expFactor / timeMs));
+    }
+
+    double sampleRate {44100.0};
+    std::array<float, MaxTimeMs - MinTimeMs + 1> coefficients {};
+};
+}
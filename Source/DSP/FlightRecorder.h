@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+
+    FlightRecorder.h
+    Created: 16 Oct 2026 11:31:09pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+ Keeps a record of the last few seconds of blocks, so a pump or a dropout that was reported can be looked at afterwards
+
+ Every processBlock leaves one record: when it started, its size and sample rate, how long it took, which parameter
+ snapshot it ran with, what it skipped, and each band's levels and gain reduction. The records go into a ring that is
+ allocated up front, so recording is always on and costs a couple of clock reads and a few stores. The audio thread
+ is the only writer and takes no lock. Each slot carries the sequence number of the record in it, which is marked as
+ being written before the record is stored and published after. writeTo copies the ring from any other thread, keeps
+ only the records whose slot held the same finished sequence number before and after the copy, and writes them
+ oldest first to a binary file that Tools/FlightRecorderDecoder turns into CSV.
+
+ The file is little endian whatever the machine: a header (see FlightRecording::writeHeader), then numRecords records
+ (see FlightRecording::writeRecord).
+ */
+namespace FlightRecording
+{
+// "SMBCFLTR", then the format version
+constexpr char magic[] = { 'S', 'M', 'B', 'C', 'F', 'L', 'T', 'R' };
+constexpr int formatVersion = 1;
+
+enum Flags : uint32_t
+{
+    ParametersChanged = 1 << 0,     // the block passed parameter changes on to the DSP
+    Idle = 1 << 1,                  // the input had been silent for longer than the tail, so only silence was written
+    DualMono = 1 << 2,              // only the first channel was processed
+    PassThrough = 1 << 3,           // every band was bypassed, so only the crossover's allpass or a copy ran
+};
+
+// The levels of one band over the block, metered by its compressor, in dB
+struct Band
+{
+    float inputRmsDb = 0.f;
+    float inputPeakDb = 0.f;
+    float outputRmsDb = 0.f;
+    float outputPeakDb = 0.f;
+    float gainReductionDb = 0.f;
+};
+
+struct Header
+{
+    int numBands = 0;
+    int numRecords = 0;
+
+    // The high resolution ticks of the records, and a tick reading taken together with the wall clock at the time
+    // of writing, which places the records in time
+    juce::int64 ticksPerSecond = 0;
+    juce::int64 ticksAtWrite = 0;
+    juce::int64 millisecondsSinceEpochAtWrite = 0;
+};
+
+inline void writeHeader(juce::OutputStream& stream, const Header& header)
+{
+    stream.write(magic, sizeof(magic));
+    stream.writeInt(formatVersion);
+    stream.writeInt(header.numBands);
+    stream.writeInt(header.numRecords);
+    stream.writeInt64(header.ticksPerSecond);
+    stream.writeInt64(header.ticksAtWrite);
+    stream.writeInt64(header.millisecondsSinceEpochAtWrite);
+}
+
+// Returns false if the stream does not start with a header this version can read
+inline bool readHeader(juce::InputStream& stream, Header& header)
+{
+    char fileMagic[sizeof(magic)] {};
+    if(stream.read(fileMagic, sizeof(fileMagic)) != static_cast<int>(sizeof(fileMagic))
+       || ! std::equal(std::begin(magic), std::end(magic), fileMagic)
+       || stream.readInt() != formatVersion){
+        return false;
+    }
+
+    header.numBands = stream.readInt();
+    header.numRecords = stream.readInt();
+    header.ticksPerSecond = stream.readInt64();
+    header.ticksAtWrite = stream.readInt64();
+    header.millisecondsSinceEpochAtWrite = stream.readInt64();
+
+    return ! stream.isExhausted() && header.numBands > 0 && header.numRecords >= 0 && header.ticksPerSecond > 0;
+}
+
+// A record as it is read back from a file, with as many bands as the file's header says
+struct DecodedRecord
+{
+    juce::int64 startTicks = 0;
+    uint32_t snapshotVersion = 0;
+    uint32_t flags = 0;
+    int32_t numSamples = 0;
+    float sampleRate = 0.f;
+    float elapsedMicroseconds = 0.f;
+    std::vector<Band> bands;
+};
+
+// Works for FlightRecorder::Record and DecodedRecord alike, which have the same fields
+template<typename RecordType>
+void writeRecord(juce::OutputStream& stream, const RecordType& record)
+{
+    stream.writeInt64(record.startTicks);
+    stream.writeInt(static_cast<int>(record.snapshotVersion));
+    stream.writeInt(static_cast<int>(record.flags));
+    stream.writeInt(record.numSamples);
+    stream.writeFloat(record.sampleRate);
+    stream.writeFloat(record.elapsedMicroseconds);
+
+    for(const auto& band : record.bands){
+        stream.writeFloat(band.inputRmsDb);
+        stream.writeFloat(band.inputPeakDb);
+        stream.writeFloat(band.outputRmsDb);
+        stream.writeFloat(band.outputPeakDb);
+        stream.writeFloat(band.gainReductionDb);
+    }
+}
+
+// The size of a record in the file
+constexpr juce::int64 getRecordSize(int numBands)
+{
+    return sizeof(juce::int64) + 5 * sizeof(uint32_t) + static_cast<juce::int64>(numBands) * 5 * sizeof(float);
+}
+
+// Returns false if the stream ends before the record does
+inline bool readRecord(juce::InputStream& stream, int numBands, DecodedRecord& record)
+{
+    if(stream.getNumBytesRemaining() < getRecordSize(numBands)){
+        return false;
+    }
+
+    record.startTicks = stream.readInt64();
+    record.snapshotVersion = static_cast<uint32_t>(stream.readInt());
+    record.flags = static_cast<uint32_t>(stream.readInt());
+    record.numSamples = stream.readInt();
+    record.sampleRate = stream.readFloat();
+    record.elapsedMicroseconds = stream.readFloat();
+
+    record.bands.resize(static_cast<size_t>(numBands));
+    for(auto& band : record.bands){
+        band.inputRmsDb = stream.readFloat();
+        band.inputPeakDb = stream.readFloat();
+        band.outputRmsDb = stream.readFloat();
+        band.outputPeakDb = stream.readFloat();
+        band.gainReductionDb = stream.readFloat();
+    }
+
+    return true;
+}
+}
+
+template<size_t NumBands>
+class FlightRecorder
+{
+public:
+    // About five seconds of 512 sample blocks at 48 kHz, some 50 kB
+    static constexpr size_t DefaultCapacity = 512;
+
+    struct Record
+    {
+        juce::int64 startTicks = 0;
+        uint32_t snapshotVersion = 0;
+        uint32_t flags = 0;
+        int32_t numSamples = 0;
+        float sampleRate = 0.f;
+        float elapsedMicroseconds = 0.f;
+        std::array<FlightRecording::Band, NumBands> bands {};
+    };
+
+    // Keeps the last numRecords records, at least one
+    explicit FlightRecorder(size_t numRecords = DefaultCapacity)
+        : capacity(juce::jmax(numRecords, size_t {1})), slots(std::make_unique<Slot[]>(capacity)) {}
+
+    // Records one processBlock from construction to destruction. The block fills in everything in record but the
+    // times and the size, and the record is written when the Scope goes
+    class Scope
+    {
+    public:
+        Scope(FlightRecorder& recorder, int numSamples, double sampleRate) noexcept : recorder(recorder)
+        {
+            record.startTicks = juce::Time::getHighResolutionTicks();
+            record.numSamples = numSamples;
+            record.sampleRate = static_cast<float>(sampleRate);
+        }
+
+        ~Scope() noexcept
+        {
+            const auto elapsedTicks = juce::Time::getHighResolutionTicks() - record.startTicks;
+            record.elapsedMicroseconds = static_cast<float>(static_cast<double>(elapsedTicks) * recorder.microsecondsPerTick);
+            recorder.write(record);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        Record record;
+
+    private:
+        FlightRecorder& recorder;
+    };
+
+    // Not real-time safe. Returns false if the file could not be written
+    bool writeTo(const juce::File& file) const
+    {
+        // Copy the newest records. Those the audio thread overwrote or was still writing while they were copied are
+        // left out
+        const auto last = numWritten.load(std::memory_order_acquire);
+        const auto first = last > capacity ? last - capacity : 0;
+
+        std::vector<Record> records;
+        records.reserve(static_cast<size_t>(last - first));
+        for(auto i = first; i < last; ++i){
+            Record record;
+            if(read(slots[i % capacity], i, record)){
+                records.push_back(record);
+            }
+        }
+
+        FlightRecording::Header header;
+        header.numBands = static_cast<int>(NumBands);
+        header.numRecords = static_cast<int>(records.size());
+        header.ticksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+        header.ticksAtWrite = juce::Time::getHighResolutionTicks();
+        header.millisecondsSinceEpochAtWrite = juce::Time::currentTimeMillis();
+
+        juce::MemoryOutputStream stream;
+        FlightRecording::writeHeader(stream, header);
+
+        for(const auto& record : records){
+            FlightRecording::writeRecord(stream, record);
+        }
+
+        return file.replaceWithData(stream.getData(), stream.getDataSize());
+    }
+
+private:
+    // A record is stored as relaxed atomic words, so a reader copying a slot the audio thread is overwriting only
+    // gets a record it throws away rather than a data race. The sequence number of record i is odd, 2 i + 1, while
+    // it is being written and even, 2 i + 2, once it is complete
+    static constexpr size_t WordsPerRecord = (sizeof(Record) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence {0};
+        std::array<std::atomic<uint64_t>, WordsPerRecord> words {};
+    };
+
+    static_assert(std::is_trivially_copyable_v<Record>);
+
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> numWritten {0};
+    const double microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+    void write(const Record& record) noexcept
+    {
+        std::array<uint64_t, WordsPerRecord> words {};
+        std::memcpy(words.data(), &record, sizeof(Record));
+
+        // The audio thread is the only writer. The fence keeps the words from being stored before the slot is marked
+        // as being written, and the release store of the finished sequence number publishes them
+        const auto index = numWritten.load(std::memory_order_relaxed);
+        auto& slot = slots[index % capacity];
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for(size_t word = 0; word < WordsPerRecord; ++word){
+            slot.words[word].store(words[word], std::memory_order_relaxed);
+        }
+
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+        numWritten.store(index + 1, std::memory_order_release);
+    }
+
+    // Copies record index out of its slot. Returns false if the slot held another record, or the writer got to it
+    // during the copy
+    static bool read(const Slot& slot, uint64_t index, Record& record) noexcept
+    {
+        const auto finished = 2 * index + 2;
+        if(slot.sequence.load(std::memory_order_acquire) != finished){
+            return false;
+        }
+
+        std::array<uint64_t, WordsPerRecord> words {};
+        for(size_t word = 0; word < WordsPerRecord; ++word){
+            words[word] = slot.words[word].load(std::memory_order_relaxed);
+        }
+
+        // Any word the writer stored after marking the slot makes this load see the mark, or a later number
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(slot.sequence.load(std::memory_order_relaxed) != finished){
+            return false;
+        }
+
+        std::memcpy(static_cast<void*>(&record), words.data(), sizeof(Record));
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(FlightRecorder)
+};
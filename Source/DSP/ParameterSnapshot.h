@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 16 Oct 2026 4:02:37pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+ Tracks which parameters have moved since the audio thread last looked
+
+ Every attached parameter gets a listener that, wherever the change comes from (the editor, host automation or a
+ state restore), sets the dirty bit of its field and then bumps a version counter. Both are lock-free atomic
+ operations, so a parameter changed from the audio thread is fine too. The audio thread compares the version with
+ the one it saw last, which is a single atomic load when nothing has moved, and only then takes the dirty bits and
+ recomputes whatever depends on those fields. A change that lands after its bit was taken sets the bit again and
+ bumps the version again, so the next block picks it up and no change is ever lost.
+ */
+template<size_t NumFields>
+class ParameterSnapshot
+{
+public:
+    ParameterSnapshot()
+    {
+        for(size_t field = 0; field < NumFields; ++field)
+        {
+            listeners[field].owner = this;
+            listeners[field].field = field;
+        }
+    }
+
+    ~ParameterSnapshot()
+    {
+        for(auto& listener : listeners)
+        {
+            if(listener.parameter != nullptr)
+                listener.parameter -> removeListener(&listener);
+        }
+    }
+
+    // Message thread, before processing starts. The parameter has to outlive the snapshot
+    void attach(size_t field, juce::AudioProcessorParameter& parameter)
+    {
+        jassert(field < NumFields);
+        jassert(listeners[field].parameter == nullptr);
+
+        listeners[field].parameter = &parameter;
+        parameter.addListener(&listeners[field]);
+        markDirty(field);
+    }
+
+    // Everything that depends on the parameters is recomputed by the next update, e.g. after prepareToPlay
+    void markAllDirty()
+    {
+        for(size_t field = 0; field < NumFields; ++field)
+        {
+            markDirty(field);
+        }
+    }
+
+    /*
+     Audio thread. Calls fieldChanged(field) once for every field whose parameter moved since the last update
+
+     Outputs:
+     - true if any field was dirty
+     */
+    template<typename Callback>
+    bool update(Callback&& fieldChanged)
+    {
+        auto currentVersion = version.load(std::memory_order_acquire);
+        if(currentVersion == lastVersion)
+            return false;
+
+        lastVersion = currentVersion;
+
+        for(size_t word = 0; word < dirtyBits.size(); ++word)
+        {
+            auto bits = dirtyBits[word].exchange(0, std::memory_order_acquire);
+            for(size_t bit = 0; bits != 0; ++bit, bits >>= 1)
+            {
+                if((bits & 1u) != 0)
+                    fieldChanged(word * bitsPerWord + bit);
+            }
+        }
+
+        return true;
+    }
+
+    // Audio thread. The version the last update brought the DSP up to, which names the set of parameter values in use
+    uint32_t getAppliedVersion() const noexcept { return lastVersion; }
+
+private:
+    static constexpr size_t bitsPerWord = 32;
+
+    struct FieldListener : juce::AudioProcessorParameter::Listener
+    {
+        void parameterValueChanged(int, float) override { owner -> markDirty(field); }
+        void parameterGestureChanged(int, bool) override {}
+
+        ParameterSnapshot* owner {nullptr};
+        size_t field {0};
+        juce::AudioProcessorParameter* parameter {nullptr};
+    };
+
+    void markDirty(size_t field)
+    {
+        // The bit is published before the version, so a reader that sees the new version also sees the bit
+        dirtyBits[field / bitsPerWord].fetch_or(1u << (field % bitsPerWord), std::memory_order_release);
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    std::array<FieldListener, NumFields> listeners;
+    std::array<std::atomic<uint32_t>, (NumFields + bitsPerWord - 1) / bitsPerWord> dirtyBits {};
+    std::atomic<uint32_t> version {0};
+
+    // Only touched by the audio thread. Starts out of step with version so the first update always looks
+    uint32_t lastVersion {~0u};
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterSnapshot)
+};
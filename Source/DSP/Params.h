@@ -11,6 +11,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../GUI/Utilities.h"
 
 namespace Params
 {
@@ -53,6 +54,16 @@ enum Names
     
     Gain_In,
     Gain_Out,
+    
+    Knee_Low_Band,
+    Knee_Mid_Band,
+    Knee_High_Band,
+    
+    Detector_Low_Band,
+    Detector_Mid_Band,
+    Detector_High_Band,
+    
+    Bypass_Phase_Match,
 };
 
 inline const std::map<Names, juce::String>& GetParams()
@@ -87,8 +98,121 @@ inline const std::map<Names, juce::String>& GetParams()
         
         {Gain_In, "Gain In"},
         {Gain_Out, "Gain Out"},
+        
+        {Knee_Low_Band, "Knee Low Band"},
+        {Knee_Mid_Band, "Knee Mid Band"},
+        {Knee_High_Band, "Knee High Band"},
+        
+        {Detector_Low_Band, "Detector Low Band"},
+        {Detector_Mid_Band, "Detector Mid Band"},
+        {Detector_High_Band, "Detector High Band"},
+        
+        {Bypass_Phase_Match, "Bypass Phase Match"},
     };
     
     return params;
 }
+
+// BandParam enumerates the parameters every compressor band owns
+// The parameter IDs for a band are generated from it, so the layout can be built for any number of bands
+enum class BandParam
+{
+    Threshold,
+    Attack,
+    Release,
+    Ratio,
+    Bypassed,
+    Mute,
+    Solo,
+    Knee,
+    Detector,
+};
+
+// Detector is the last BandParam
+static constexpr size_t NumBandParams = static_cast<size_t>(BandParam::Detector) + 1;
+
+// The compression ratios offered by the Ratio choice, in choice order
+// The layout builds the choice names from this table and the compressors read the ratio back out of it by index
+static constexpr std::array<float, 14> RatioChoices {1, 1.5f, 2, 3, 4, 5, 6, 7, 8, 10, 15, 20, 50, 100};
+
+inline juce::String getBandParamID(BandParam param, size_t band, size_t numBands)
+{
+    // The three band layout maps onto the original Names so that saved sessions and the GUI keep working
+    if(numBands == 3)
+    {
+        static const std::map<BandParam, Names> lowBandNames =
+        {
+            {BandParam::Threshold, Threshold_Low_Band},
+            {BandParam::Attack, Attack_Low_Band},
+            {BandParam::Release, Release_Low_Band},
+            {BandParam::Ratio, Ratio_Low_Band},
+            {BandParam::Bypassed, Bypassed_Low_Band},
+            {BandParam::Mute, Mute_Low_Band},
+            {BandParam::Solo, Solo_Low_Band},
+            {BandParam::Knee, Knee_Low_Band},
+            {BandParam::Detector, Detector_Low_Band},
+        };
+        
+        // The Low/Mid/High entries of each parameter are consecutive in Names
+        return GetParams().at(static_cast<Names>(lowBandNames.at(param) + static_cast<int>(band)));
+    }
+    
+    static const std::map<BandParam, juce::String> paramNames =
+    {
+        {BandParam::Threshold, "Threshold"},
+        {BandParam::Attack, "Attack"},
+        {BandParam::Release, "Release"},
+        {BandParam::Ratio, "Ratio"},
+        {BandParam::Bypassed, "Bypassed"},
+        {BandParam::Mute, "Mute"},
+        {BandParam::Solo, "Solo"},
+        {BandParam::Knee, "Knee"},
+        {BandParam::Detector, "Detector"},
+    };
+    
+    return paramNames.at(param) + " Band " + juce::String(static_cast<int>(band + 1));
+}
+
+inline juce::String getCrossoverParamID(size_t crossover, size_t numBands)
+{
+    if(numBands == 3)
+    {
+        return GetParams().at(static_cast<Names>(Low_Mid_Crossover_Freq + static_cast<int>(crossover)));
+    }
+    
+    return "Crossover " + juce::String(static_cast<int>(crossover + 1)) + " Freq";
+}
+
+// Each crossover gets its own slice of the frequency range, so neighbouring crossovers can never swap places
+inline juce::NormalisableRange<float> getCrossoverRange(size_t crossover, size_t numBands)
+{
+    if(numBands == 3)
+    {
+        return crossover == 0 ? juce::NormalisableRange<float>(MIN_FREQUENCY, 999, 1, 1)
+                              : juce::NormalisableRange<float>(1000, MAX_FREQUENCY, 1, 1);
+    }
+    
+    // Otherwise the slices are equally wide on a log scale
+    auto numCrossovers = static_cast<float>(numBands - 1);
+    auto edge = [numCrossovers](size_t i)
+    {
+        return std::round(MIN_FREQUENCY * std::pow(MAX_FREQUENCY / MIN_FREQUENCY, static_cast<float>(i) / numCrossovers));
+    };
+    
+    auto start = edge(crossover);
+    auto end = crossover + 2 == numBands ? MAX_FREQUENCY : edge(crossover + 1) - 1;
+    return juce::NormalisableRange<float>(start, end, 1, 1);
+}
+
+inline float getCrossoverDefault(size_t crossover, size_t numBands)
+{
+    if(numBands == 3)
+    {
+        return crossover == 0 ? 400.f : 2000.f;
+    }
+    
+    // The geometric centre of the crossover's slice
+    auto range = getCrossoverRange(crossover, numBands);
+    return std::round(std::sqrt(range.start * range.end));
+}
 }
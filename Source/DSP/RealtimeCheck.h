@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.h
+    Created: 16 Oct 2026 7:12:48pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifndef SIMPLEMBCOMP_REALTIME_CHECKS
+ #define SIMPLEMBCOMP_REALTIME_CHECKS 0
+#endif
+
+/*
+ Marks the code that runs on behalf of the audio callback, for the real-time safety harness
+
+ The harness (Tools/RealtimeSafety) replaces the allocator and the pthread mutex lock with versions that report any
+ call made while a Scope is open on the calling thread. Scopes nest. The worker pool opens one around the tasks it
+ runs, so the band workers are checked along with the audio thread. Only the harness defines
+ SIMPLEMBCOMP_REALTIME_CHECKS, everywhere else a Scope is an empty struct.
+ */
+namespace RealtimeCheck
+{
+#if SIMPLEMBCOMP_REALTIME_CHECKS
+// How many scopes are open on this thread
+inline thread_local int depth = 0;
+
+struct Scope
+{
+    Scope() noexcept { ++depth; }
+    ~Scope() noexcept { --depth; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+#else
+struct Scope
+{
+    // User-provided, so an unused Scope does not warn
+    Scope() noexcept {}
+};
+#endif
+}
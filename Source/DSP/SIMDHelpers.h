@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    SIMDHelpers.h
+    Created: 16 Oct 2026 10:02:15am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace SIMDHelpers
+{
+
+// Lane buffers and filter states are aligned to a cache line, which also satisfies every SIMD register width
+static constexpr size_t LaneAlignment = 64;
+
+template<typename Vec>
+inline Vec select(typename Vec::vMaskType mask, Vec ifTrue, Vec ifFalse)
+{
+    /*
+     Branch-free per-lane choice between two registers
+
+     Inputs:
+     - mask: all bits set in the lanes that should take ifTrue, all bits clear in the others
+     - ifTrue: the values used where the mask is set
+     - ifFalse: the values used where the mask is clear
+     Outputs:
+     - A register holding ifTrue or ifFalse in each lane
+     */
+    // The halves are combined bitwise, since adding them would turn a -0 in ifTrue into +0
+    typename Vec::vMaskType ifFalseBits;
+    const auto ifFalsePart = ifFalse & ~mask;
+    std::memcpy(&ifFalseBits, &ifFalsePart, sizeof(ifFalseBits));
+    return (ifTrue & mask) | ifFalseBits;
+}
+
+// SIMDRegister::fromRawArray and copyToRawArray need 16-byte aligned pointers, which the host's buffers and odd
+// offsets into the arenas are not. These take any pointer, and compile to the same unaligned moves the AVX tables use
+template<typename Vec>
+inline Vec load(const typename Vec::ElementType* source)
+{
+    Vec x;
+    std::memcpy(&x, source, sizeof(Vec));
+    return x;
+}
+
+template<typename Vec>
+inline void store(typename Vec::ElementType* destination, Vec x)
+{
+    std::memcpy(destination, &x, sizeof(Vec));
+}
+
+template<typename Vec>
+inline typename Vec::vMaskType loadMask(const typename Vec::MaskType* lanes)
+{
+    return load<typename Vec::vMaskType>(lanes);
+}
+
+template<typename Vec>
+inline Vec abs(Vec x)
+{
+    return Vec::max(x, Vec::expand(0) - x);
+}
+}
@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+    StageTimer.h
+    Created: 16 Oct 2026 8:58:14pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+#ifndef SIMPLEMBCOMP_STAGE_TIMING
+ #define SIMPLEMBCOMP_STAGE_TIMING 0
+#endif
+
+/*
+ Times every stage of processBlock from the CPU's cycle counter, to see which stage eats the budget without a profiler
+
+ A stage's ticks are added up over a block, over every tile and chunk it ran on, and the block's total goes into that
+ stage's statistics once the block ends. The audio thread writes the statistics, the band workers only add to their
+ own band's running total, and anything else reads them without a lock. The counters only ever grow, so a reader
+ diffs two readings for the numbers of an interval. Only builds that define SIMPLEMBCOMP_STAGE_TIMING keep any of
+ this. Everywhere else the timer and its scopes are empty and the editor leaves out its overlay.
+ */
+namespace StageTiming
+{
+#if SIMPLEMBCOMP_STAGE_TIMING
+// When set, the stages count whatever this reads instead of time. The benchmark uses it to count hardware events per
+// stage (see Tools/Benchmark). It may only be changed while no block is being processed
+struct TickSource
+{
+    uint64_t (*read)(void* context) noexcept = nullptr;
+    void* context = nullptr;
+};
+
+inline TickSource tickSource;
+#endif
+
+// The time stamp counter on Intel and the virtual counter on 64-bit ARM, which ticks at a fixed rate rather than with
+// the core clock. The high resolution ticks everywhere else
+inline uint64_t readTicks() noexcept
+{
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    if(tickSource.read != nullptr){
+        return tickSource.read(tickSource.context);
+    }
+   #endif
+
+   #if JUCE_INTEL
+    return __rdtsc();
+   #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+   #else
+    return static_cast<uint64_t>(juce::Time::getHighResolutionTicks());
+   #endif
+}
+}
+
+template<size_t NumBands>
+class StageTimer
+{
+public:
+    // The stages in the order they run. InputGain and OutputGain only fill the gain ramps, since the gains themselves
+    // are applied inside SplitBands and SumBands. Block is the whole of processBlock
+    static constexpr size_t UpdateState = 0;
+    static constexpr size_t AnalyzerFeed = UpdateState + 1;
+    static constexpr size_t InputGain = AnalyzerFeed + 1;
+    static constexpr size_t SplitBands = InputGain + 1;
+    static constexpr size_t FirstBand = SplitBands + 1;
+    static constexpr size_t SumBands = FirstBand + NumBands;
+    static constexpr size_t OutputGain = SumBands + 1;
+    static constexpr size_t Block = OutputGain + 1;
+    static constexpr size_t NumStages = Block + 1;
+
+    static juce::String getStageName(size_t stage)
+    {
+        if(stage >= FirstBand && stage < SumBands){
+            return "Band " + juce::String(stage - FirstBand + 1);
+        }
+
+        switch(stage){
+            case UpdateState: return "Update state";
+            case AnalyzerFeed: return "Analyzer feed";
+            case InputGain: return "Input gain";
+            case SplitBands: return "Split bands";
+            case SumBands: return "Sum bands";
+            case OutputGain: return "Output gain";
+            case Block: return "Block";
+            default: jassertfalse; return {};
+        }
+    }
+
+#if SIMPLEMBCOMP_STAGE_TIMING
+    // Bucket b counts the blocks that took [2^(b - 1), 2^b) ticks, bucket 0 the ones where the stage did not run
+    static constexpr size_t NumBuckets = 48;
+
+    struct Statistics
+    {
+        uint64_t numBlocks = 0;
+        uint64_t totalTicks = 0;
+        uint64_t maxTicks = 0;
+        std::array<uint64_t, NumBuckets> histogram {};
+    };
+
+    // Adds the ticks from construction to destruction to the stage's total for the current block
+    class Scope
+    {
+    public:
+        Scope(StageTimer& timer, size_t stage) noexcept : timer(timer), stage(stage), start(StageTiming::readTicks()) {}
+        ~Scope() noexcept { timer.add(stage, StageTiming::readTicks() - start); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StageTimer& timer;
+        size_t stage;
+        uint64_t start;
+    };
+
+    // Times the Block stage, then passes every stage's total for the block on to its statistics. It has to outlive
+    // every other Scope of the block
+    class BlockScope
+    {
+    public:
+        explicit BlockScope(StageTimer& timer) noexcept : timer(timer), start(StageTiming::readTicks()) {}
+
+        ~BlockScope() noexcept
+        {
+            timer.add(Block, StageTiming::readTicks() - start);
+            timer.endBlock();
+        }
+
+        BlockScope(const BlockScope&) = delete;
+        BlockScope& operator=(const BlockScope&) = delete;
+
+    private:
+        StageTimer& timer;
+        uint64_t start;
+    };
+
+    Statistics getStatistics(size_t stage) const
+    {
+        const auto& counters = stages[stage];
+
+        Statistics statistics;
+        statistics.numBlocks = counters.numBlocks.load(std::memory_order_relaxed);
+        statistics.totalTicks = counters.totalTicks.load(std::memory_order_relaxed);
+        statistics.maxTicks = counters.maxTicks.load(std::memory_order_relaxed);
+        for(size_t bucket = 0; bucket < NumBuckets; ++bucket){
+            statistics.histogram[bucket] = counters.histogram[bucket].load(std::memory_order_relaxed);
+        }
+
+        return statistics;
+    }
+
+    // The longest block since the last call, for a display of recent maxima. A block that ends at the same time may
+    // be missed, which a display polling a few times a second can live with
+    uint64_t takeRecentMaxTicks(size_t stage)
+    {
+        return stages[stage].recentMaxTicks.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    // Only one thread writes each counter at a time: the band workers are joined before the block ends, so plain
+    // loads and stores are enough and no read-modify-write is needed on the audio thread
+    struct StageCounters
+    {
+        std::atomic<uint64_t> blockTicks {0};
+        std::atomic<uint64_t> numBlocks {0};
+        std::atomic<uint64_t> totalTicks {0};
+        std::atomic<uint64_t> maxTicks {0};
+        std::atomic<uint64_t> recentMaxTicks {0};
+        std::array<std::atomic<uint64_t>, NumBuckets> histogram {};
+    };
+
+    std::array<StageCounters, NumStages> stages;
+
+    void add(size_t stage, uint64_t ticks) noexcept
+    {
+        auto& blockTicks = stages[stage].blockTicks;
+        blockTicks.store(blockTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    }
+
+    void endBlock() noexcept
+    {
+        auto increment = [](std::atomic<uint64_t>& counter, uint64_t amount)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        };
+
+        for(auto& counters : stages){
+            const auto ticks = counters.blockTicks.load(std::memory_order_relaxed);
+            counters.blockTicks.store(0, std::memory_order_relaxed);
+
+            increment(counters.numBlocks, 1);
+            increment(counters.totalTicks, ticks);
+            increment(counters.histogram[getBucket(ticks)], 1);
+
+            if(ticks > counters.maxTicks.load(std::memory_order_relaxed)){
+                counters.maxTicks.store(ticks, std::memory_order_relaxed);
+            }
+            if(ticks > counters.recentMaxTicks.load(std::memory_order_relaxed)){
+                counters.recentMaxTicks.store(ticks, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static size_t getBucket(uint64_t ticks) noexcept
+    {
+        size_t bucket = 0;
+        while(ticks > 0 && bucket < NumBuckets - 1){
+            ticks >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+#else
+    struct Scope
+    {
+        Scope(StageTimer&, size_t) noexcept {}
+    };
+
+    struct BlockScope
+    {
+        explicit BlockScope(StageTimer&) noexcept {}
+    };
+#endif
+};
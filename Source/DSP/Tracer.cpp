@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    Tracer.cpp
+    Created: 16 Oct 2026 10:38:20pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "Tracer.h"
+
+#if SIMPLEMBCOMP_TRACING
+Tracer& Tracer::getInstance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : startTicks(juce::Time::getHighResolutionTicks())
+{
+    for(auto& thread : threads){
+        thread.events = std::make_unique<Event[]>(EventsPerThread);
+    }
+}
+
+Tracer::ThreadBuffer* Tracer::claimBuffer() noexcept
+{
+    const auto index = numClaimed.fetch_add(1, std::memory_order_relaxed);
+    if(index >= MaxThreads){
+        return nullptr;
+    }
+
+    // The message thread and the band workers have names of their own. The only other thread that opens a Scope is
+    // the one the host calls processBlock on. Copying a juce::String only counts a reference, so nothing allocates
+    auto& buffer = threads[index];
+    if(juce::MessageManager::existsAndIsCurrentThread()){
+        std::snprintf(buffer.threadName, sizeof(buffer.threadName), "%s", "Message thread");
+    } else if(auto* thread = juce::Thread::getCurrentThread()){
+        thread -> getThreadName().copyToUTF8(buffer.threadName, sizeof(buffer.threadName));
+    } else{
+        std::snprintf(buffer.threadName, sizeof(buffer.threadName), "%s", "Audio thread");
+    }
+
+    buffer.isClaimed.store(true, std::memory_order_release);
+    return &buffer;
+}
+
+void Tracer::record(const char* name, int argument, juce::int64 start, juce::int64 end) noexcept
+{
+    // A thread that found no free buffer does not ask again
+    static thread_local ThreadBuffer* buffer = nullptr;
+    static thread_local bool hasClaimed = false;
+
+    if(!hasClaimed){
+        buffer = claimBuffer();
+        hasClaimed = true;
+    }
+
+    if(buffer == nullptr){
+        return;
+    }
+
+    // This thread is the buffer's only writer. The fence keeps the fields from being stored before the event is
+    // marked as being written, and the release store of the finished sequence number publishes them
+    const auto index = buffer -> numRecorded.load(std::memory_order_relaxed);
+    auto& event = buffer -> events[index % EventsPerThread];
+    event.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    event.argument.store(argument, std::memory_order_relaxed);
+
+    event.sequence.store(2 * index + 2, std::memory_order_release);
+    buffer -> numRecorded.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::writeChromeTrace(const juce::File& file) const
+{
+    const auto microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    auto toMicroseconds = [this, microsecondsPerTick](juce::int64 ticks)
+    {
+        return juce::String(static_cast<double>(ticks - startTicks) * microsecondsPerTick, 3);
+    };
+
+    juce::MemoryOutputStream json;
+    json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"SimpleMBComp\"}}";
+
+    struct Copy
+    {
+        const char* name;
+        juce::int64 start, end;
+        int argument;
+    };
+
+    std::vector<Copy> copies(EventsPerThread);
+    for(size_t thread = 0; thread < MaxThreads; ++thread){
+        const auto& buffer = threads[thread];
+        if(!buffer.isClaimed.load(std::memory_order_acquire)){
+            continue;
+        }
+
+        const auto tid = juce::String(thread + 1);
+        json << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+             << ",\"args\":{\"name\":\"" << buffer.threadName << "\"}}"
+             << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+             << ",\"args\":{\"sort_index\":" << tid << "}}";
+
+        // Copy the newest events. Those the thread overwrote or was still writing while they were copied are left out
+        const auto last = buffer.numRecorded.load(std::memory_order_acquire);
+        const auto first = last > EventsPerThread ? last - EventsPerThread : 0;
+        size_t numCopies = 0;
+        for(auto i = first; i < last; ++i){
+            const auto& event = buffer.events[i % EventsPerThread];
+            const auto finished = 2 * i + 2;
+            if(event.sequence.load(std::memory_order_acquire) != finished){
+                continue;
+            }
+
+            const Copy copy {event.name.load(std::memory_order_relaxed), event.start.load(std::memory_order_relaxed),
+                             event.end.load(std::memory_order_relaxed), event.argument.load(std::memory_order_relaxed)};
+
+            // Any field the thread stored after marking the event makes this load see the mark, or a later number
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(event.sequence.load(std::memory_order_relaxed) == finished){
+                copies[numCopies++] = copy;
+            }
+        }
+
+        for(size_t i = 0; i < numCopies; ++i){
+            const auto& event = copies[i];
+            json << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                 << ",\"ts\":" << toMicroseconds(event.start)
+                 << ",\"dur\":" << juce::String(static_cast<double>(event.end - event.start) * microsecondsPerTick, 3);
+
+            if(event.argument >= 0){
+                json << ",\"args\":{\"index\":" << juce::String(event.argument) << "}";
+            }
+
+            json << "}";
+        }
+    }
+
+    json << "\n]}\n";
+
+    // Replacing through a temporary file leaves no half written trace behind
+    return file.replaceWithData(json.getData(), json.getDataSize());
+}
+#endif
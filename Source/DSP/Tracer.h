@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    Tracer.h
+    Created: 16 Oct 2026 10:38:20pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef SIMPLEMBCOMP_TRACING
+ #define SIMPLEMBCOMP_TRACING 0
+#endif
+
+/*
+ Records when the audio, band worker and message threads were busy, to lay them side by side in Perfetto
+ (ui.perfetto.dev) or chrome://tracing
+
+ Each Scope becomes one complete event, a name with a start and a duration, in a ring buffer of the thread that opened
+ it. A thread claims its buffer the first time it opens a Scope, and only ever writes to that one, so recording takes no
+ lock and allocates nothing: every buffer is allocated when the Tracer is created. Once a ring is full its oldest
+ events are overwritten. Every event carries a sequence number that marks it as being written and then publishes it.
+ writeChromeTrace copies every ring while the threads keep writing, keeps only the events whose number was the same
+ finished one before and after the copy, and writes them as Chrome trace JSON, one track per thread. Only builds that define
+ SIMPLEMBCOMP_TRACING keep any of this. Everywhere else a Scope is empty.
+ */
+class Tracer
+{
+public:
+    // Threads beyond the first MaxThreads to open a Scope are not traced. The band workers are restarted by every
+    // prepareToPlay, and each restart takes new buffers
+    static constexpr size_t MaxThreads = 32;
+    static constexpr size_t EventsPerThread = 1 << 14;
+
+#if SIMPLEMBCOMP_TRACING
+    // The one Tracer of the process, shared by every instance of the plugin. Created on first use, so the processor
+    // calls this from its constructor before the audio thread can
+    static Tracer& getInstance();
+
+    // Records the time from construction to destruction as one event. The name has to outlive the Tracer, so it is
+    // best a string literal. A non-negative argument is shown with the event, e.g. which band it was
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name, int argument = -1) noexcept
+            : name(name), argument(argument), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~Scope() noexcept { getInstance().record(name, argument, start, juce::Time::getHighResolutionTicks()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        int argument;
+        juce::int64 start;
+    };
+
+    // Not real-time safe. Returns false if the file could not be written
+    bool writeChromeTrace(const juce::File& file) const;
+
+private:
+    Tracer();
+
+    // Every field is atomic since writeChromeTrace may read an event while its thread overwrites it. The copy is then
+    // thrown away, but the read itself must not be a data race. The sequence number of event i is odd, 2 i + 1, while
+    // it is being written and even, 2 i + 2, once it is complete
+    struct Event
+    {
+        std::atomic<uint64_t> sequence {0};
+        std::atomic<const char*> name {nullptr};
+        std::atomic<juce::int64> start {0};
+        std::atomic<juce::int64> end {0};
+        std::atomic<int> argument {-1};
+    };
+
+    struct ThreadBuffer
+    {
+        // Written once by the thread that claims the buffer, before it sets isClaimed
+        char threadName[64] {};
+        std::atomic<bool> isClaimed {false};
+
+        // How many events the thread has ever recorded. Event i lives at i % EventsPerThread
+        std::atomic<uint64_t> numRecorded {0};
+        std::unique_ptr<Event[]> events;
+    };
+
+    std::array<ThreadBuffer, MaxThreads> threads;
+    std::atomic<size_t> numClaimed {0};
+
+    const juce::int64 startTicks;
+
+    ThreadBuffer* claimBuffer() noexcept;
+    void record(const char* name, int argument, juce::int64 start, juce::int64 end) noexcept;
+#else
+    struct Scope
+    {
+        explicit Scope(const char*, int = -1) noexcept {}
+    };
+#endif
+};
@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    WorkerPool.cpp
+    Created: 16 Oct 2026 2:05:27pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "WorkerPool.h"
+#include "RealtimeCheck.h"
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <cerrno>
+ #include <semaphore.h>
+#endif
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+// How many times an idle worker checks for new tasks before it parks. At 48 kHz a 2048 sample block lasts about
+// 43 ms, so a worker that found nothing for this long is better off asleep
+constexpr int spinsBeforeParking = 4000;
+
+// How many times the calling thread checks the join before it parks. The tasks are whole band chains, so once
+// the calling thread has run out of its own a short spin covers a worker that is nearly done, and anything
+// longer means the worker is not running and the calling thread should yield its core to it
+constexpr int spinsBeforeWaitingAtJoin = 1000;
+
+inline void pause()
+{
+   #if JUCE_INTEL
+    _mm_pause();
+   #elif JUCE_ARM
+    __asm__ __volatile__ ("yield");
+   #endif
+}
+}
+
+/*
+ The operating system semaphores are posted without any user space lock, unlike juce::WaitableEvent,
+ so the audio thread can wake a parked worker
+ */
+struct WorkerPool::Semaphore
+{
+   #if JUCE_MAC || JUCE_IOS
+    Semaphore() : semaphore(dispatch_semaphore_create(0)) {}
+    ~Semaphore() { dispatch_release(semaphore); }
+    void post() { dispatch_semaphore_signal(semaphore); }
+    void wait() { dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER); }
+
+    dispatch_semaphore_t semaphore;
+   #elif JUCE_WINDOWS
+    Semaphore() : semaphore(CreateSemaphore(nullptr, 0, MAXLONG, nullptr)) {}
+    ~Semaphore() { CloseHandle(semaphore); }
+    void post() { ReleaseSemaphore(semaphore, 1, nullptr); }
+    void wait() { WaitForSingleObject(semaphore, INFINITE); }
+
+    HANDLE semaphore;
+   #else
+    Semaphore() { sem_init(&semaphore, 0, 0); }
+    ~Semaphore() { sem_destroy(&semaphore); }
+    void post() { sem_post(&semaphore); }
+    void wait() { while(sem_wait(&semaphore) != 0 && errno == EINTR) {} }
+
+    sem_t semaphore;
+   #endif
+};
+
+struct WorkerPool::Worker : juce::Thread
+{
+    Worker(WorkerPool& ownerPool, int index)
+        : juce::Thread("Band worker " + juce::String(index)), owner(ownerPool)
+    {
+    }
+
+    void run() override
+    {
+        owner.workerLoop();
+    }
+
+    WorkerPool& owner;
+};
+
+WorkerPool::WorkerPool()
+    : parking(std::make_unique<Semaphore>()),
+      joined(std::make_unique<Semaphore>())
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start(int numWorkers, double sampleRate, int maximumBlockSize)
+{
+    if(numWorkers == workers.size() && sampleRate == workerSampleRate && maximumBlockSize == workerBlockSize)
+        return;
+
+    stop();
+
+    workerSampleRate = sampleRate;
+    workerBlockSize = maximumBlockSize;
+
+    // The same class of thread as the audio thread, with its callback period, so the scheduler does not let
+    // anything else run in between while the audio thread waits at the join
+    const auto options = juce::Thread::RealtimeOptions {}.withApproximateAudioProcessingTime(maximumBlockSize, sampleRate);
+
+    shouldExit = false;
+    for(int i = 0; i < numWorkers; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i));
+
+        // Real-time threads can be refused, e.g. without the rights for them on Linux
+        if(! worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void WorkerPool::stop()
+{
+    if(workers.isEmpty())
+        return;
+
+    shouldExit = true;
+    for(int i = 0; i < workers.size(); ++i)
+    {
+        parking->post();
+    }
+
+    for(auto* worker : workers)
+    {
+        worker->stopThread(-1);
+    }
+
+    workers.clear();
+
+    // Posts nobody waited for would otherwise wake the next set of workers straight away
+    numParked = 0;
+    parking = std::make_unique<Semaphore>();
+}
+
+void WorkerPool::run(size_t numTasks, TaskFunction function, const void* context)
+{
+    jassert(numTasks <= MaxTasks);
+
+    if(workers.isEmpty() || numTasks < 2)
+    {
+        for(size_t i = 0; i < numTasks; ++i)
+        {
+            function(context, i);
+        }
+
+        return;
+    }
+
+    // The previous job has been joined, so no worker can still be reading these
+    taskFunction = function;
+    taskContext = context;
+    remainingTasks.store(numTasks, std::memory_order_relaxed);
+
+    auto generation = getGeneration(cursor.load(std::memory_order_relaxed)) + 1;
+    cursor.store(pack(generation, numTasks, 0), std::memory_order_release);
+
+    // Only the workers that went to sleep need a post. The spinning ones see the new cursor by themselves
+    for(auto parked = numParked.exchange(0, std::memory_order_acq_rel); parked > 0; --parked)
+    {
+        parking->post();
+    }
+
+    // The calling thread takes tasks too, then waits at the join for any still running on a worker
+    runTasks(generation);
+
+    for(int spins = 0; spins < spinsBeforeWaitingAtJoin; ++spins)
+    {
+        if(remainingTasks.load(std::memory_order_acquire) == 0)
+            return;
+
+        pause();
+    }
+
+    // Flag the park before the last look at the counter, so the thread that finishes the last task after it
+    // sees the flag and posts. If the counter is already 0 and that thread took the flag anyway, its post is on
+    // the way and has to be consumed here, or the next join would return early
+    callerParked.store(true, std::memory_order_seq_cst);
+    if(remainingTasks.load(std::memory_order_seq_cst) != 0 || ! callerParked.exchange(false, std::memory_order_seq_cst))
+        joined->wait();
+}
+
+void WorkerPool::runTasks(uint32_t generation)
+{
+    // The tasks are part of the audio callback, whichever thread runs them
+    RealtimeCheck::Scope realtimeScope;
+
+    auto current = cursor.load(std::memory_order_acquire);
+
+    while(getGeneration(current) == generation && getNextTask(current) < getNumTasks(current))
+    {
+        if(! cursor.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        taskFunction(taskContext, getNextTask(current));
+
+        // The last task to finish wakes the calling thread if it gave up spinning at the join
+        if(remainingTasks.fetch_sub(1, std::memory_order_seq_cst) == 1 && callerParked.exchange(false, std::memory_order_seq_cst))
+            joined->post();
+
+        current = cursor.load(std::memory_order_acquire);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    // The audio thread sets this for itself in processBlock, the workers have to set it for themselves
+    juce::ScopedNoDenormals noDenormals;
+
+    auto lastGeneration = getGeneration(cursor.load(std::memory_order_acquire));
+    int spins = 0;
+
+    while(! shouldExit.load(std::memory_order_acquire))
+    {
+        auto generation = getGeneration(cursor.load(std::memory_order_acquire));
+        if(generation != lastGeneration)
+        {
+            lastGeneration = generation;
+            runTasks(generation);
+            spins = 0;
+            continue;
+        }
+
+        if(++spins < spinsBeforeParking)
+        {
+            pause();
+            continue;
+        }
+
+        // Register as parked before the last look at the cursor, so a job published in between still gets a post
+        // A post that arrives after the worker has already seen the job only causes one spurious wake up later
+        numParked.fetch_add(1, std::memory_order_acq_rel);
+        if(getGeneration(cursor.load(std::memory_order_acquire)) == lastGeneration && ! shouldExit.load(std::memory_order_acquire))
+            parking->wait();
+
+        spins = 0;
+    }
+}
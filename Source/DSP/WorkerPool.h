@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    WorkerPool.h
+    Created: 16 Oct 2026 2:05:27pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+ A fork-join pool for running the band chains in parallel on large blocks
+
+ The threads are started and stopped from the message thread (prepareToPlay/releaseResources). On the audio
+ thread parallelFor only touches atomics: the tasks are published with a single store, idle workers pick them
+ up by spinning for a short while and then parking on a semaphore, and the calling thread takes tasks too
+ before it waits at the join. Nothing in parallelFor allocates or takes a lock, and a semaphore post is only
+ made for a thread that has actually parked.
+
+ The audio thread waits on the workers, so they run as real-time threads like it does. Otherwise a busy
+ machine could preempt a worker while the audio thread spins on its result. The join only spins for a short
+ while too, then parks the calling thread until the last task finishes, so it never burns its own deadline
+ on a worker that has been descheduled anyway.
+ */
+class WorkerPool
+{
+public:
+    WorkerPool();
+    ~WorkerPool();
+
+    /*
+     Starts the worker threads. Not real-time safe
+
+     Inputs:
+     - numWorkers: how many threads to start. A running pool with a different size or timing is restarted
+     - sampleRate, maximumBlockSize: the audio callback the workers help with, which the operating system uses
+       to schedule them as real-time threads
+     Outputs:
+     - None
+     */
+    void start(int numWorkers, double sampleRate, int maximumBlockSize);
+    void stop();
+
+    bool isRunning() const { return ! workers.isEmpty(); }
+    int getNumWorkers() const { return workers.size(); }
+
+    /*
+     Runs task(i) for every i in [0, numTasks) across the workers and the calling thread
+
+     Inputs:
+     - numTasks: the number of tasks. At most MaxTasks
+     - task: called once per index. It must be safe to call from several threads at once
+     Outputs:
+     - None
+     - Returns once every task has finished. With no workers running, the tasks run in order on the calling thread
+     */
+    template<typename Task>
+    void parallelFor(size_t numTasks, const Task& task)
+    {
+        run(numTasks, [](const void* context, size_t index) { (*static_cast<const Task*>(context))(index); }, &task);
+    }
+
+    static constexpr size_t MaxTasks = 0xffff;
+
+private:
+    using TaskFunction = void (*)(const void* context, size_t index);
+
+    void run(size_t numTasks, TaskFunction function, const void* context);
+    void runTasks(uint32_t generation);
+    void workerLoop();
+
+    // The job cursor packs [generation:32][numTasks:16][nextTask:16], so a task index can only be claimed for
+    // the job it was published with
+    static constexpr uint64_t pack(uint32_t generation, size_t numTasks, size_t nextTask)
+    {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(numTasks) << 16) | static_cast<uint64_t>(nextTask);
+    }
+
+    static constexpr uint32_t getGeneration(uint64_t cursor) { return static_cast<uint32_t>(cursor >> 32); }
+    static constexpr size_t getNumTasks(uint64_t cursor) { return static_cast<size_t>((cursor >> 16) & 0xffff); }
+    static constexpr size_t getNextTask(uint64_t cursor) { return static_cast<size_t>(cursor & 0xffff); }
+
+    std::atomic<uint64_t> cursor {0};
+    std::atomic<size_t> remainingTasks {0};
+
+    // Only written by the calling thread before the cursor is published, and only read after claiming a task
+    TaskFunction taskFunction {nullptr};
+    const void* taskContext {nullptr};
+
+    std::atomic<int> numParked {0};
+    std::atomic<bool> shouldExit {false};
+
+    // Set by the calling thread before it parks at the join, taken by whichever thread finishes the last task
+    std::atomic<bool> callerParked {false};
+
+    struct Semaphore;
+    std::unique_ptr<Semaphore> parking, joined;
+
+    double workerSampleRate {0};
+    int workerBlockSize {0};
+
+    struct Worker;
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(WorkerPool)
+};
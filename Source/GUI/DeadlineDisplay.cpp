@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    DeadlineDisplay.cpp
+    Created: 16 Oct 2026 10:05:12pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "DeadlineDisplay.h"
+#include "../DSP/Tracer.h"
+
+DeadlineDisplay::DeadlineDisplay(DeadlineMonitor& m, SimpleMBCompAudioProcessor::FlightRecords& recorder)
+    : monitor(m), flightRecorder(recorder)
+{
+    startTimerHz(4);
+}
+
+void DeadlineDisplay::timerCallback()
+{
+    report = monitor.getReport();
+    repaint();
+}
+
+void DeadlineDisplay::paint(juce::Graphics& g)
+{
+    using namespace juce;
+
+    auto percent = [](double load) { return String(load * 100.0, 1) + "%"; };
+
+    const auto text = "p99 " + percent(report.p99) + "  max " + percent(report.max)
+                    + "  overruns " + String(report.numOverruns);
+
+    g.setColour(report.numOverruns > 0 ? Colours::red : Colours::lightgrey);
+    g.setFont(10.f);
+    g.drawFittedText(text, getLocalBounds(), Justification::centredRight, 1);
+}
+
+void DeadlineDisplay::mouseUp(const juce::MouseEvent& e)
+{
+    if(! e.mouseWasDraggedSinceMouseDown())
+    {
+        showMenu();
+    }
+}
+
+void DeadlineDisplay::showMenu()
+{
+    juce::PopupMenu menu;
+    menu.addItem("Save report...", [safeThis = SafePointer<DeadlineDisplay>(this)]
+    {
+        if(safeThis != nullptr)
+        {
+            safeThis->saveToFile("Save the deadline report", "SimpleMBComp deadlines.txt",
+                                 [&monitor = safeThis->monitor](const juce::File& file){ return monitor.writeReport(file); });
+        }
+    });
+    menu.addItem("Reset", [&monitor = monitor]{ monitor.requestReset(); });
+    
+    menu.addSeparator();
+    menu.addItem("Save flight recording...", [safeThis = SafePointer<DeadlineDisplay>(this)]
+    {
+        if(safeThis != nullptr)
+        {
+            safeThis->saveToFile("Save the flight recording", "SimpleMBComp flight.smbcflight",
+                                 [&recorder = safeThis->flightRecorder](const juce::File& file){ return recorder.writeTo(file); });
+        }
+    });
+    
+   #if SIMPLEMBCOMP_TRACING
+    // The trace covers the audio and message threads of every instance, not just this one's deadlines
+    menu.addItem("Save trace...", [safeThis = SafePointer<DeadlineDisplay>(this)]
+    {
+        if(safeThis != nullptr)
+        {
+            safeThis->saveToFile("Save the trace for Perfetto", "SimpleMBComp trace.json",
+                                 [](const juce::File& file){ return Tracer::getInstance().writeChromeTrace(file); });
+        }
+    });
+   #endif
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+void DeadlineDisplay::saveToFile(const juce::String& title, const juce::String& defaultFileName,
+                                 std::function<bool(const juce::File&)> write)
+{
+    auto defaultFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile(defaultFileName);
+
+    fileChooser = std::make_unique<juce::FileChooser>(title, defaultFile, "*" + defaultFile.getFileExtension());
+
+    auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting;
+    fileChooser->launchAsync(flags, [title, write = std::move(write)](const juce::FileChooser& chooser)
+    {
+        auto file = chooser.getResult();
+        if(file != juce::File() && ! write(file))
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                   title, "Could not write " + file.getFullPathName());
+        }
+    });
+}
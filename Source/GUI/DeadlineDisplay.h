@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    DeadlineDisplay.h
+    Created: 16 Oct 2026 10:05:12pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+/*
+ A one line summary of the processor's DeadlineMonitor: the p99 and maximum block load and the number of overruns,
+ in red once there has been one. Clicking it offers to save the full report to a file or to start counting again, to
+ save the flight recorder's last blocks (see DSP/FlightRecorder.h), and in builds with SIMPLEMBCOMP_TRACING to save
+ the trace of the audio and message threads (see DSP/Tracer.h)
+ */
+struct DeadlineDisplay : juce::Component, juce::Timer
+{
+    DeadlineDisplay(DeadlineMonitor& monitor, SimpleMBCompAudioProcessor::FlightRecords& flightRecorder);
+
+    void paint(juce::Graphics& g) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+    void timerCallback() override;
+
+private:
+    DeadlineMonitor& monitor;
+    SimpleMBCompAudioProcessor::FlightRecords& flightRecorder;
+    DeadlineMonitor::Report report;
+
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    void showMenu();
+
+    // Asks for a file, suggesting defaultFileName in the documents folder, and writes it with write
+    void saveToFile(const juce::String& title, const juce::String& defaultFileName,
+                    std::function<bool(const juce::File&)> write);
+};
@@ -12,6 +12,7 @@
 #include <JuceHeader.h>
 #include "Utilities.h"
 #include "../DSP/Fifo.h"
+#include "../DSP/FastMath.h"
 
 template<typename BlockType>
 struct FFTDataGenerator
@@ -54,7 +55,7 @@ struct FFTDataGenerator
         //convert them to decibels
         for( int i = 0; i < numBins; ++i )
         {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+            fftData[i] = FastMath::gainToDecibels(fftData[i], negativeInfinity);
         }
         
         fftDataFifo.push(fftData);
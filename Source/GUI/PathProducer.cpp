@@ -9,9 +9,11 @@
 */
 
 #include "PathProducer.h"
+#include "../DSP/Tracer.h"
 
 void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
 {
+    Tracer::Scope trace("PathProducer::process");
     juce::AudioBuffer<float> tempIncomingBuffer;
     while( leftChannelFifo->getNumCompleteBuffersAvailable() > 0 )
     {
@@ -11,6 +11,7 @@
 #include "SpectrumAnalyzer.h"
 #include "Utilities.h"
 #include "../DSP/Params.h"
+#include "../DSP/Tracer.h"
 
 SpectrumAnalyzer::SpectrumAnalyzer(SimpleMBCompAudioProcessor& p) :
 audioProcessor(p),
@@ -81,6 +82,7 @@ void SpectrumAnalyzer::drawFFTAnalysis(juce::Graphics &g, juce::Rectangle<int> b
 
 void SpectrumAnalyzer::paint (juce::Graphics& g)
 {
+    Tracer::Scope trace("SpectrumAnalyzer::paint");
     using namespace juce;
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (Colours::black);
@@ -319,21 +321,19 @@ void SpectrumAnalyzer::drawCrossovers(juce::Graphics &g, juce::Rectangle<int> bo
 
 void SpectrumAnalyzer::update(const std::vector<float> &values)
 {
-    jassert(values.size() == 6);
+    jassert(values.size() == 3);
     
     enum
     {
-        LowBandIn,
-        LowBandOut,
-        MidBandIn,
-        MidBandOut,
-        HighBandIn,
-        HighBandOut
+        LowBand,
+        MidBand,
+        HighBand
     };
     
-    lowBandGR = values[LowBandOut] - values[LowBandIn];
-    midBandGR = values[MidBandOut] - values[MidBandIn];
-    highBandGR = values[HighBandOut] - values[HighBandIn];
+    // The compressors report the gain reduction they actually applied, so there is nothing to estimate here
+    lowBandGR = values[LowBand];
+    midBandGR = values[MidBand];
+    highBandGR = values[HighBand];
     
     repaint();
 }
@@ -358,6 +358,7 @@ void SpectrumAnalyzer::parameterValueChanged(int parameterIndex, float newValue)
 
 void SpectrumAnalyzer::timerCallback()
 {
+    Tracer::Scope trace("SpectrumAnalyzer::timerCallback");
     if( shouldShowFFTAnalysis )
     {
         auto fftBounds = getAnalysisArea(getLocalBounds()).toFloat();
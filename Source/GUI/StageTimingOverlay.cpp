@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    StageTimingOverlay.cpp
+    Created: 16 Oct 2026 9:14:51pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "StageTimingOverlay.h"
+
+#if SIMPLEMBCOMP_STAGE_TIMING
+StageTimingOverlay::StageTimingOverlay(SimpleMBCompAudioProcessor& p) :
+audioProcessor(p),
+firstTicks(StageTiming::readTicks()),
+firstHighResolutionTicks(juce::Time::getHighResolutionTicks())
+{
+    setInterceptsMouseClicks(false, false);
+
+    for(size_t stage = 0; stage < StageTimes::NumStages; ++stage)
+    {
+        previousStatistics[stage] = audioProcessor.stageTimes.getStatistics(stage);
+        audioProcessor.stageTimes.takeRecentMaxTicks(stage);
+    }
+
+    startTimerHz(2);
+}
+
+juce::Rectangle<int> StageTimingOverlay::getPreferredBounds() const
+{
+    // A header line and one line per stage, with a little room around them
+    return { width, lineHeight * static_cast<int>(StageTimes::NumStages + 1) + 8 };
+}
+
+void StageTimingOverlay::timerCallback()
+{
+    const auto elapsedTicks = static_cast<double>(StageTiming::readTicks() - firstTicks);
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - firstHighResolutionTicks);
+
+    if(elapsedTicks <= 0.0 || elapsedSeconds <= 0.0)
+        return;
+
+    const auto microsecondsPerTick = elapsedSeconds * 1.0e6 / elapsedTicks;
+
+    for(size_t stage = 0; stage < StageTimes::NumStages; ++stage)
+    {
+        const auto statistics = audioProcessor.stageTimes.getStatistics(stage);
+        const auto& previous = previousStatistics[stage];
+        const auto numBlocks = statistics.numBlocks - previous.numBlocks;
+
+        auto& row = rows[stage];
+        row.averageMicroseconds = numBlocks > 0 ? static_cast<double>(statistics.totalTicks - previous.totalTicks) / static_cast<double>(numBlocks) * microsecondsPerTick
+                                                : 0.0;
+        row.maxMicroseconds = static_cast<double>(audioProcessor.stageTimes.takeRecentMaxTicks(stage)) * microsecondsPerTick;
+
+        previousStatistics[stage] = statistics;
+    }
+
+    const auto sampleRate = audioProcessor.getSampleRate();
+    budgetMicroseconds = sampleRate > 0.0 ? audioProcessor.getBlockSize() / sampleRate * 1.0e6 : 0.0;
+
+    repaint();
+}
+
+void StageTimingOverlay::paint(juce::Graphics& g)
+{
+    using namespace juce;
+
+    g.setColour(Colours::black.withAlpha(0.75f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.f);
+
+    g.setFont(Font(Font::getDefaultMonospacedFontName(), 10.f, Font::plain));
+    g.setColour(Colours::lightgrey);
+
+    auto bounds = getLocalBounds().reduced(6, 4);
+
+    auto drawLine = [&g, &bounds](const String& name, const String& average, const String& max, const String& budget)
+    {
+        auto line = bounds.removeFromTop(lineHeight);
+        g.drawText(name, line.removeFromLeft(85), Justification::centredLeft);
+        g.drawText(average, line.removeFromLeft(45), Justification::centredRight);
+        g.drawText(max, line.removeFromLeft(45), Justification::centredRight);
+        g.drawText(budget, line, Justification::centredRight);
+    };
+
+    drawLine("Stage", "avg us", "max us", "budget");
+
+    for(size_t stage = 0; stage < StageTimes::NumStages; ++stage)
+    {
+        const auto& row = rows[stage];
+        const auto share = budgetMicroseconds > 0.0 ? String(100.0 * row.averageMicroseconds / budgetMicroseconds, 1) + "%"
+                                                    : String("-");
+
+        // The whole block goes red once its longest run no longer fits the budget
+        if(stage == StageTimes::Block && budgetMicroseconds > 0.0 && row.maxMicroseconds > budgetMicroseconds)
+            g.setColour(Colours::red);
+
+        drawLine(StageTimes::getStageName(stage), String(row.averageMicroseconds, 1), String(row.maxMicroseconds, 1), share);
+    }
+}
+#endif
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    StageTimingOverlay.h
+    Created: 16 Oct 2026 9:14:51pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#if SIMPLEMBCOMP_STAGE_TIMING
+/*
+ Shows how long each stage of processBlock took over the last half second: the average and the longest block in
+ microseconds, and the average as a share of the real-time budget of a block of the prepared size
+
+ The processor counts cycle counter ticks (see DSP/StageTimer.h). They are converted to time by how far the counter
+ moved against juce::Time::getHighResolutionTicks since the overlay was created, so the first readings are rough.
+ The overlay does not take mouse clicks, so it can sit on top of the analyzer.
+ */
+struct StageTimingOverlay : juce::Component, juce::Timer
+{
+    explicit StageTimingOverlay(SimpleMBCompAudioProcessor&);
+
+    void paint(juce::Graphics& g) override;
+    void timerCallback() override;
+
+    // The size the overlay needs for its text
+    juce::Rectangle<int> getPreferredBounds() const;
+
+private:
+    using StageTimes = SimpleMBCompAudioProcessor::StageTimes;
+
+    SimpleMBCompAudioProcessor& audioProcessor;
+
+    std::array<StageTimes::Statistics, StageTimes::NumStages> previousStatistics;
+
+    struct Row
+    {
+        double averageMicroseconds = 0.0;
+        double maxMicroseconds = 0.0;
+    };
+
+    std::array<Row, StageTimes::NumStages> rows;
+    double budgetMicroseconds = 0.0;
+
+    uint64_t firstTicks;
+    juce::int64 firstHighResolutionTicks;
+
+    static constexpr int lineHeight = 12;
+    static constexpr int width = 220;
+};
+#endif
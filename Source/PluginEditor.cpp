@@ -9,6 +9,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "DSP/Params.h"
+#include "DSP/Tracer.h"
 
 ControlBar::ControlBar()
 {
@@ -49,6 +50,10 @@ SimpleMBCompAudioProcessorEditor::SimpleMBCompAudioProcessorEditor (SimpleMBComp
     addAndMakeVisible(analyzer);
     addAndMakeVisible(globalControls);
     addAndMakeVisible(bandControls);
+    addAndMakeVisible(deadlineDisplay);
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    addAndMakeVisible(stageTimingOverlay);
+   #endif
     setSize (600, 500);
     
     startTimerHz(60);
@@ -62,6 +67,7 @@ SimpleMBCompAudioProcessorEditor::~SimpleMBCompAudioProcessorEditor()
 //==============================================================================
 void SimpleMBCompAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    Tracer::Scope trace("SimpleMBCompAudioProcessorEditor::paint");
     g.fillAll(juce::Colours::black);
 }
 
@@ -70,25 +76,30 @@ void SimpleMBCompAudioProcessorEditor::resized()
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
     auto bounds = getLocalBounds();
-    controlBar.setBounds(bounds.removeFromTop(32));
+    auto topBar = bounds.removeFromTop(32);
+    deadlineDisplay.setBounds(topBar.removeFromRight(230).reduced(6, 0));
+    controlBar.setBounds(topBar);
     bandControls.setBounds(bounds.removeFromBottom(135));
     analyzer.setBounds(bounds.removeFromTop(225));
     globalControls.setBounds(bounds);
+    
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    auto overlayBounds = stageTimingOverlay.getPreferredBounds();
+    stageTimingOverlay.setBounds(overlayBounds.withPosition(analyzer.getRight() - overlayBounds.getWidth() - 4, analyzer.getY() + 4));
+   #endif
 }
 
-// Callback with a timer to retrieve the RMS levels for gain reduction GUI update
+// Callback with a timer to retrieve the gain reduction of each band for the GUI update
 
 void SimpleMBCompAudioProcessorEditor::timerCallback()
 {
-    std::vector<float> values
+    Tracer::Scope trace("SimpleMBCompAudioProcessorEditor::timerCallback");
+    // The gain reduction each compressor applied, from the lowest band to the highest
+    std::vector<float> values;
+    for(const auto& comp : audioProcessor.compressors)
     {
-        audioProcessor.lowBandComp.getRMSInputLevelDb(),
-        audioProcessor.lowBandComp.getRMSOutputLevelDb(),
-        audioProcessor.midBandComp.getRMSInputLevelDb(),
-        audioProcessor.midBandComp.getRMSOutputLevelDb(),
-        audioProcessor.highBandComp.getRMSInputLevelDb(),
-        audioProcessor.highBandComp.getRMSOutputLevelDb(),
-    };
+        values.push_back(comp.getGainReductionDb());
+    }
     
     analyzer.update(values);
     
@@ -122,24 +133,20 @@ void SimpleMBCompAudioProcessorEditor::toggleGlobalBypassState()
     bandControls.toggleAllBands(!shouldEnableEveryting);
 }
 
-std::array<juce::AudioParameterBool*, 3> SimpleMBCompAudioProcessorEditor::getBypassParams()
+SimpleMBCompAudioProcessorEditor::BypassParams SimpleMBCompAudioProcessorEditor::getBypassParams()
 {
     using namespace Params;
-    using namespace juce;
-    const auto& params = Params::GetParams();
     auto& apvts = audioProcessor.apvts;
+    constexpr auto numBands = SimpleMBCompAudioProcessor::NumBands;
     
-    auto boolHelper = [&apvts, &params](const auto& paramName)
+    BypassParams bypassParams;
+    for(size_t band = 0; band < numBands; ++band)
     {
-        auto param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
+        auto* param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(getBandParamID(BandParam::Bypassed, band, numBands)));
         jassert(param != nullptr);
         
-        return param;
-    };
-    
-    auto* lowBypassParam = boolHelper(Names::Bypassed_Low_Band);
-    auto* midBypassParam = boolHelper(Names::Bypassed_Mid_Band);
-    auto* highBypassParam = boolHelper(Names::Bypassed_High_Band);
+        bypassParams[band] = param;
+    }
     
-    return {lowBypassParam, midBypassParam, highBypassParam};
+    return bypassParams;
 }
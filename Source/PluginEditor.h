@@ -34,6 +34,11 @@ GUI Roadmap:
 #include "GUI/UtilityComponents.h"
 #include "GUI/SpectrumAnalyzer.h"
 #include "GUI/CustomButtons.h"
+#include "GUI/StageTimingOverlay.h"
+#include "GUI/DeadlineDisplay.h"
+
+// The band controls, band select buttons and analyzer overlays are laid out for three bands
+static_assert(SimpleMBCompAudioProcessor::NumBands == 3, "The editor only supports the three band layout");
 
 struct ControlBar : juce::Component
 {
@@ -69,9 +74,16 @@ private:
     GlobalControls globalControls { audioProcessor.apvts };
     CompressorBandControls bandControls { audioProcessor.apvts };
     SpectrumAnalyzer analyzer { audioProcessor };
+    DeadlineDisplay deadlineDisplay { audioProcessor.deadlines, audioProcessor.flightRecorder };
+    
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    // Only built in with the stage timing, drawn over the analyzer
+    StageTimingOverlay stageTimingOverlay { audioProcessor };
+   #endif
     
     void toggleGlobalBypassState();
-    std::array<juce::AudioParameterBool*, 3> getBypassParams();
+    using BypassParams = std::array<juce::AudioParameterBool*, SimpleMBCompAudioProcessor::NumBands>;
+    BypassParams getBypassParams();
     
     void updateGlobalBypassButton();
     
@@ -9,6 +9,8 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "DSP/Params.h"
+#include "DSP/RealtimeCheck.h"
+#include "DSP/Tracer.h"
 
 //==============================================================================
 SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
@@ -28,68 +30,75 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
     const auto& params = GetParams();
     
     // Retrieve pointers to float type parameters
-    auto floatHelper = [&apvts = this -> apvts, &params](auto& param, const auto& paramName)
+    auto floatHelper = [&apvts = this -> apvts](auto& param, const auto& paramID)
     {
-        param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(params.at(paramName)));
+        param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(paramID));
         jassert(param != nullptr);
     };
     
-    floatHelper(lowBandComp.attack,     Names::Attack_Low_Band);
-    floatHelper(lowBandComp.release,    Names::Release_Low_Band);
-    floatHelper(lowBandComp.threshold,  Names::Threshold_Low_Band);
-    
-    floatHelper(midBandComp.attack,     Names::Attack_Mid_Band);
-    floatHelper(midBandComp.release,    Names::Release_Mid_Band);
-    floatHelper(midBandComp.threshold,  Names::Threshold_Mid_Band);
-    
-    floatHelper(highBandComp.attack,    Names::Attack_High_Band);
-    floatHelper(highBandComp.release,   Names::Release_High_Band);
-    floatHelper(highBandComp.threshold, Names::Threshold_High_Band);
-    
-    floatHelper(lowMidCrossover,    Names::Low_Mid_Crossover_Freq);
-    floatHelper(midHighCrossover,   Names::Mid_High_Crossover_Freq);
-    
-    floatHelper(inputGainParam,    Names::Gain_In);
-    floatHelper(outputGainParam,   Names::Gain_Out);
-    
     // Retrieve pointers to choice type parameters
-    auto choiceHelper = [&apvts = this -> apvts, &params](auto& param, const auto& paramName)
+    auto choiceHelper = [&apvts = this -> apvts](auto& param, const auto& paramID)
     {
-        param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(params.at(paramName)));
+        param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(paramID));
         jassert(param != nullptr);
     };
     
-    choiceHelper(lowBandComp.ratio,     Names::Ratio_Low_Band);
-    choiceHelper(midBandComp.ratio,     Names::Ratio_Mid_Band);
-    choiceHelper(highBandComp.ratio,    Names::Ratio_High_Band);
-    
     // Retrieve pointers to bool type parameters
-    auto boolHelper = [&apvts = this -> apvts, &params](auto& param, const auto& paramName)
+    auto boolHelper = [&apvts = this -> apvts](auto& param, const auto& paramID)
     {
-        param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
+        param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(paramID));
         jassert(param != nullptr);
     };
-     
-    boolHelper(lowBandComp.bypassed,    Names::Bypassed_Low_Band);
-    boolHelper(midBandComp.bypassed,    Names::Bypassed_Mid_Band);
-    boolHelper(highBandComp.bypassed,   Names::Bypassed_High_Band);
     
-    boolHelper(lowBandComp.mute,    Names::Mute_Low_Band);
-    boolHelper(midBandComp.mute,    Names::Mute_Mid_Band);
-    boolHelper(highBandComp.mute,   Names::Mute_High_Band);
+    for(size_t band = 0; band < NumBands; ++band)
+    {
+        auto& comp = compressors[band];
+        
+        floatHelper(comp.attack,     getBandParamID(BandParam::Attack, band, NumBands));
+        floatHelper(comp.release,    getBandParamID(BandParam::Release, band, NumBands));
+        floatHelper(comp.threshold,  getBandParamID(BandParam::Threshold, band, NumBands));
+        
+        floatHelper(comp.knee,       getBandParamID(BandParam::Knee, band, NumBands));
+        
+        choiceHelper(comp.ratio,     getBandParamID(BandParam::Ratio, band, NumBands));
+        choiceHelper(comp.detector,  getBandParamID(BandParam::Detector, band, NumBands));
+        
+        boolHelper(comp.bypassed,    getBandParamID(BandParam::Bypassed, band, NumBands));
+        boolHelper(comp.mute,        getBandParamID(BandParam::Mute, band, NumBands));
+        boolHelper(comp.solo,        getBandParamID(BandParam::Solo, band, NumBands));
+    }
+    
+    for(size_t i = 0; i < crossoverFrequencies.size(); ++i)
+    {
+        floatHelper(crossoverFrequencies[i], getCrossoverParamID(i, NumBands));
+    }
     
-    boolHelper(lowBandComp.solo,    Names::Solo_Low_Band);
-    boolHelper(midBandComp.solo,    Names::Solo_Mid_Band);
-    boolHelper(highBandComp.solo,   Names::Solo_High_Band);
+    floatHelper(inputGainParam,    params.at(Names::Gain_In));
+    floatHelper(outputGainParam,   params.at(Names::Gain_Out));
+    boolHelper(bypassPhaseMatchParam, params.at(Names::Bypass_Phase_Match));
     
-    // Set the filter types
-    LP1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+    // Watch every parameter so that updateState only recomputes what has changed
+    for(size_t i = 0; i < crossoverFrequencies.size(); ++i)
+    {
+        parameterSnapshot.attach(i, *crossoverFrequencies[i]);
+    }
     
-    AP2.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+    parameterSnapshot.attach(inputGainField, *inputGainParam);
+    parameterSnapshot.attach(outputGainField, *outputGainParam);
     
-    LP2.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP2.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+    for(size_t band = 0; band < NumBands; ++band)
+    {
+        for(size_t param = 0; param < NumBandParams; ++param)
+        {
+            auto& parameter = *apvts.getParameter(getBandParamID(static_cast<BandParam>(param), band, NumBands));
+            parameterSnapshot.attach(firstBandField + band * NumBandParams + param, parameter);
+        }
+    }
+    
+   #if SIMPLEMBCOMP_TRACING
+    // The tracer allocates all of its buffers when it is created, which must not be on the audio thread
+    Tracer::getInstance();
+   #endif
 }
 
 SimpleMBCompAudioProcessor::~SimpleMBCompAudioProcessor()
@@ -131,7 +140,7 @@ bool SimpleMBCompAudioProcessor::isMidiEffect() const
 
 double SimpleMBCompAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return calculateTailSeconds(silenceFloorDb.load());
 }
 
 int SimpleMBCompAudioProcessor::getNumPrograms()
@@ -167,31 +176,67 @@ void SimpleMBCompAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     // Prepare the necessary specs
     juce::dsp::ProcessSpec spec;
     spec.maximumBlockSize = samplesPerBlock;
+    preparedBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumOutputChannels();
     spec.sampleRate = sampleRate;
     
+    // Pick the widest kernels this CPU can run, once, before anything that processes audio is prepared
+    auto isa = forcedKernelIsa.value_or(DSPKernels::getBestSupportedIsa());
+    jassert(DSPKernels::isSupported(isa));
+    kernels = &DSPKernels::getTable(DSPKernels::isSupported(isa) ? isa : DSPKernels::Isa::Scalar);
+    
     for(auto& comp : compressors){
-        comp.prepare(spec);
+        comp.prepare(spec, *kernels);
     }
     
-    LP1.prepare(spec);
-    HP1.prepare(spec);
-    
-    AP2.prepare(spec);
+    crossover.prepare(spec, *kernels);
     
-    LP2.prepare(spec);
-    HP2.prepare(spec);
+    // Everything prepared above starts from its defaults, so every setting is passed on again by the next block
+    parameterSnapshot.markAllDirty();
     
-    inputGain.prepare(spec);
-    outputGain.prepare(spec);
-    // Set a 50ms ramp time to prevent clicks and pops
-    inputGain.setRampDurationSeconds(0.05);
-    outputGain.setRampDurationSeconds(0.05);
+    // The floor is compared again by the first updateState, which also works out the tail for the new sample rate
+    idleFloorDb = 1.f;
+    silentSamples = 0;
+    idle = false;
+    identicalSamples = 0;
+    dualMono = false;
     
-    for(auto& buffer : filterBuffers){
-        buffer.setSize(spec.numChannels, samplesPerBlock);
+    // The calling thread compresses one band itself, so at most one worker per remaining band is useful
+    auto threshold = parallelBandThreshold.load();
+    auto numWorkers = juce::jmin(static_cast<int>(NumBands) - 1, juce::SystemStats::getNumCpus() - 1);
+    if(threshold > 0 && samplesPerBlock >= threshold && numWorkers > 0){
+        bandWorkers.start(numWorkers, sampleRate, samplesPerBlock);
+    } else{
+        bandWorkers.stop();
     }
     
+    deadlines.prepare(sampleRate);
+    
+    // Set a 50ms ramp time to prevent clicks and pops
+    inputGain.reset(sampleRate, gainRampSeconds);
+    outputGain.reset(sampleRate, gainRampSeconds);
+    gainRamps = juce::dsp::AudioBlock<float>(gainRampArena, 2, spec.maximumBlockSize, bandArenaAlignment);
+    
+    // Always start on the full path. The crossover was just reset, so there is no state to hand over
+    passthroughMix.reset(sampleRate, passthroughFadeSeconds);
+    passthroughMix.setCurrentAndTargetValue(0.f);
+    passthroughWasRunning = false;
+    bandsWereRunning = true;
+    allpassIsCurrent = false;
+    
+    passthroughArenaBlock = juce::dsp::AudioBlock<float>(passthroughArena,
+                                                         spec.numChannels,
+                                                         spec.maximumBlockSize,
+                                                         bandArenaAlignment);
+    passthroughFade.allocate(spec.maximumBlockSize, true);
+    
+    // Allocate a single aligned arena holding every band's channels. The bands are views into it (see splitBands)
+    bandArenaBlock = juce::dsp::AudioBlock<float>(bandArena,
+                                                  spec.numChannels * filterBuffers.size(),
+                                                  spec.maximumBlockSize,
+                                                  bandArenaAlignment);
+    bandArenaBlock.clear();
+    
     leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
     
@@ -209,6 +254,14 @@ void SimpleMBCompAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    bandWorkers.stop();
+}
+
+void SimpleMBCompAudioProcessor::setGainControlInterval(int samples)
+{
+    for(auto& compressor : compressors){
+        compressor.setGainControlInterval(static_cast<size_t>(juce::jmax(1, samples)));
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -237,58 +290,168 @@ bool SimpleMBCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
 }
 #endif
 
-void SimpleMBCompAudioProcessor::updateState()
+bool SimpleMBCompAudioProcessor::updateState()
 {
-    // Update compressor settings
+    // Only the parameters that moved since the last block are passed on, so a block with no changes costs one atomic load
+    auto parametersChanged = parameterSnapshot.update([this](size_t field){ updateParameter(field); });
+    
+    // The tail depends on the release times, the crossover frequencies and the floor
+    auto floorDb = silenceFloorDb.load(std::memory_order_relaxed);
+    if(parametersChanged || floorDb != idleFloorDb){
+        idleFloorDb = floorDb;
+        idleFloorGain = juce::Decibels::decibelsToGain(floorDb, -1000.f);
+        tailSamples = static_cast<int64_t>(std::ceil(calculateTailSeconds(floorDb) * getSampleRate()));
+    }
+    
+    return parametersChanged;
+}
+
+double SimpleMBCompAudioProcessor::calculateTailSeconds(float floorDb) const
+{
+    // Once the input stops, everything that remembers it decays exponentially. The tail is how long the slowest of
+    // them takes to fall from full scale to the floor
+    // A floor below -200 dB would only stretch the tail towards infinity for nothing
+    auto timeConstants = std::log(1.0 / juce::Decibels::decibelsToGain(static_cast<double>(juce::jmax(floorDb, -200.f)), -1000.0));
+    auto slowest = 0.0;
+    
+    // The compressor envelopes release with a time constant of release / 2 pi (see FastMath::EnvelopeCoefficientTable)
     for(auto& comp : compressors){
-        comp.updateCompressorSettings();
+        slowest = juce::jmax(slowest, comp.release -> get() / 1000.0 / juce::MathConstants<double>::twoPi);
     }
     
-    // Update input and output gain settings
-    inputGain.setGainDecibels(inputGainParam -> get());
-    outputGain.setGainDecibels(outputGainParam -> get());
+    // The crossover poles decay with a time constant of sqrt(2) / (2 pi fc), the slowest at the lowest crossover
+    for(auto* frequency : crossoverFrequencies){
+        slowest = juce::jmax(slowest, juce::MathConstants<double>::sqrt2 / (juce::MathConstants<double>::twoPi * frequency -> get()));
+    }
     
+    return slowest * timeConstants;
+}
+
+bool SimpleMBCompAudioProcessor::updateIdleState(const juce::AudioBuffer<float>& buffer)
+{
+    auto peak = 0.f;
+    for(int channel = 0; channel < buffer.getNumChannels(); ++channel){
+        peak = juce::jmax(peak, buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
+    }
+    
+    // Any sample above the floor resumes processing from that block on
+    if(peak > idleFloorGain){
+        silentSamples = 0;
+        idle = false;
+        return false;
+    }
+    
+    silentSamples = juce::jmin(silentSamples + buffer.getNumSamples(), tailSamples);
+    if(silentSamples < tailSamples){
+        return false;
+    }
+    
+    // By now every filter and envelope has decayed below the floor, so they restart from silence when the input
+    // comes back, which is where they would have ended up anyway
+    if(!idle){
+        idle = true;
+        crossover.reset();
+        for(auto& comp : compressors){
+            comp.reset();
+        }
+    }
+    
+    return true;
+}
+
+void SimpleMBCompAudioProcessor::updateParameter(size_t field)
+{
     // Set cutoff frequencies
-    auto lowMidCutoffFreq = lowMidCrossover -> get();
-    LP1.setCutoffFrequency(lowMidCutoffFreq);
-    HP1.setCutoffFrequency(lowMidCutoffFreq);
-    auto midHighCutoffFreq = midHighCrossover -> get();
-    AP2.setCutoffFrequency(midHighCutoffFreq);
-    LP2.setCutoffFrequency(midHighCutoffFreq);
-    HP2.setCutoffFrequency(midHighCutoffFreq);
+    if(field < inputGainField){
+        crossover.setCrossoverFrequency(field, crossoverFrequencies[field] -> get());
+        return;
+    }
+    
+    // Update input and output gain settings
+    if(field == inputGainField){
+        inputGain.setTargetValue(juce::Decibels::decibelsToGain(inputGainParam -> get()));
+        return;
+    }
+    
+    if(field == outputGainField){
+        outputGain.setTargetValue(juce::Decibels::decibelsToGain(outputGainParam -> get()));
+        return;
+    }
+    
+    // Update compressor settings
+    auto bandField = field - firstBandField;
+    compressors[bandField / Params::NumBandParams].updateCompressorSetting(static_cast<Params::BandParam>(bandField % Params::NumBandParams));
 }
 
-void SimpleMBCompAudioProcessor::splitBands(const juce::AudioBuffer<float>& inputBuffer)
+void SimpleMBCompAudioProcessor::splitBands(const juce::dsp::AudioBlock<float>& inputBlock, const float* inputGains, float inputGain)
 {
-    // Copy the single input buffer into each buffer in filterBuffers
-    for(auto& fb : filterBuffers){
-        fb = inputBuffer;
+    // The arena is sized for the prepared block size, so a larger block would run off the end of it
+    jassert(inputBlock.getNumSamples() <= bandArenaBlock.getNumSamples());
+    
+    // Point each band at its own channels in the arena, trimmed to the length of this block
+    const auto channelsPerBand = bandArenaBlock.getNumChannels() / filterBuffers.size();
+    const auto numChannels = juce::jmin(inputBlock.getNumChannels(), channelsPerBand);
+    const auto numSamples = inputBlock.getNumSamples();
+    
+    for(size_t i = 0; i < filterBuffers.size(); ++i){
+        filterBuffers[i] = bandArenaBlock.getSubsetChannelBlock(i * channelsPerBand, numChannels)
+                                         .getSubBlock(0, numSamples);
     }
     
-    // Set necessary process contexts
-    auto fb0Block = juce::dsp::AudioBlock<float>(filterBuffers[0]);
-    auto fb1Block = juce::dsp::AudioBlock<float>(filterBuffers[1]);
-    auto fb2Block = juce::dsp::AudioBlock<float>(filterBuffers[2]);
+    // The filters run out-of-place from the input straight into the bands, so the input is never copied, nor gained
+    auto input = juce::dsp::AudioBlock<const float>(inputBlock.getSubsetChannelBlock(0, numChannels));
     
-    auto fb0Ctx = juce::dsp::ProcessContextReplacing<float>(fb0Block);
-    auto fb1Ctx = juce::dsp::ProcessContextReplacing<float>(fb1Block);
-    auto fb2Ctx = juce::dsp::ProcessContextReplacing<float>(fb2Block);
+    crossover.process(input, filterBuffers, inputGains, inputGain);
+}
+
+bool SimpleMBCompAudioProcessor::canPassThrough(const std::array<bool, NumBands>& bandIsHeard) const
+{
+    // Anything that would make the output differ from the sum of the untouched bands rules it out
+    for(size_t i = 0; i < compressors.size(); ++i){
+        if(!bandIsHeard[i] || !compressors[i].bypassed -> get()){
+            return false;
+        }
+    }
+    
+    return inputGainParam -> get() == 0.f && outputGainParam -> get() == 0.f
+        && !inputGain.isSmoothing() && !outputGain.isSmoothing();
+}
+
+bool SimpleMBCompAudioProcessor::updateDualMonoState(const juce::AudioBuffer<float>& buffer)
+{
+    // memcmp is as cheap a vectorised compare as there is, and it stops at the first sample that differs
+    const auto numSamples = buffer.getNumSamples();
+    auto channelsMatch = buffer.getNumChannels() > 1 && dualMonoEnabled.load(std::memory_order_relaxed);
+    for(int channel = 1; channel < buffer.getNumChannels() && channelsMatch; ++channel){
+        channelsMatch = std::memcmp(buffer.getReadPointer(0), buffer.getReadPointer(channel), sizeof(float) * static_cast<size_t>(numSamples)) == 0;
+    }
     
-    // LinkwitzRiley Process Low Band filter
-    LP1.process(fb0Ctx);
-    AP2.process(fb0Ctx);
+    // Hysteresis: going dual mono waits for the states to converge, leaving it happens on the first block that differs
+    identicalSamples = channelsMatch ? juce::jmin(identicalSamples + numSamples, tailSamples) : 0;
+    const auto processAsMono = channelsMatch && identicalSamples >= tailSamples;
     
-    // LinkwitzRiley Process High Band filter
-    HP1.process(fb1Ctx);
-    filterBuffers[2] = filterBuffers[1];
-    LP2.process(fb1Ctx);
+    // The other channels were not processed, but with the same input they would have stayed in the state of the first
+    if(dualMono && !processAsMono){
+        for(int channel = 1; channel < buffer.getNumChannels(); ++channel){
+            crossover.copyChannelState(0, static_cast<size_t>(channel));
+            for(auto& comp : compressors){
+                comp.copyChannelState(0, static_cast<size_t>(channel));
+            }
+        }
+    }
     
-    // LinkwitzRiley Process Mid Band filter
-    HP2.process(fb2Ctx);
+    dualMono = processAsMono;
+    return dualMono;
 }
 
 void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    // Nothing in here may allocate or lock, which the real-time safety harness checks (see DSP/RealtimeCheck.h)
+    RealtimeCheck::Scope realtimeScope;
+    DeadlineMonitor::Scope deadline(deadlines, buffer.getNumSamples());
+    FlightRecords::Scope flight(flightRecorder, buffer.getNumSamples(), getSampleRate());
+    StageTimes::BlockScope blockTiming(stageTimes);
+    Tracer::Scope trace("processBlock");
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -303,7 +466,11 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         buffer.clear (i, 0, buffer.getNumSamples());
     
     // Update state
-    updateState();
+    {
+        StageTimes::Scope timing(stageTimes, StageTimes::UpdateState);
+        Tracer::Scope trace("Update state");
+        deadline.parametersChanged = updateState();
+    }
     
     // Testing oscillator
     if( false ){
@@ -317,35 +484,69 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
     
     // Feed audio into the spectrum analyzer
-    leftChannelFifo.update(buffer);
-    rightChannelFifo.update(buffer);
+    // The left FIFO reads channel 1 (see Channel), which a mono layout does not have
+    {
+        StageTimes::Scope timing(stageTimes, StageTimes::AnalyzerFeed);
+        Tracer::Scope trace("Analyzer feed");
+        if(buffer.getNumChannels() > Channel::Left){
+            leftChannelFifo.update(buffer);
+        }
+        rightChannelFifo.update(buffer);
+    }
     
-    // Apply input gain before we do any compression
-    applyGain(buffer, inputGain);
+    // Everything the DSP allocates is sized for the block size prepareToPlay was given, but offline bounces and
+    // variable-size callbacks can send more than that. Such blocks are processed in chunks no larger than the prepared
+    // size, so nothing ever allocates on the audio thread. The chunks only refer to the host buffer's channels
+    jassert(preparedBlockSize > 0);
+    const auto numSamples = buffer.getNumSamples();
+    if(numSamples <= preparedBlockSize){
+        processChunk(buffer);
+    } else{
+        for(int start = 0; start < numSamples; start += preparedBlockSize){
+            auto chunk = juce::AudioBuffer<float>(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, juce::jmin(preparedBlockSize, numSamples - start));
+            processChunk(chunk);
+        }
+    }
     
-    // Here is the general scheme: First, we copy the input buffer into each band's buffer. We then process each band separately. Finally, we merge the bands.
+    describeBlock(flight.record, deadline.parametersChanged);
+}
+
+void SimpleMBCompAudioProcessor::describeBlock(FlightRecords::Record& record, bool parametersChanged) const
+{
+    using namespace FlightRecording;
     
-    // Split the whole frequency range to three filter bands
-    splitBands(buffer);
+    record.snapshotVersion = parameterSnapshot.getAppliedVersion();
+    record.flags = (parametersChanged ? ParametersChanged : 0u) | (idle ? Idle : 0u)
+                 | (dualMono ? DualMono : 0u) | (bandsWereRunning ? 0u : PassThrough);
     
-    // Compress each individual band
-    // Note that the bypass functionality is done within the process function
-    for(size_t i = 0; i < filterBuffers.size(); ++i){
-        compressors[i].process(filterBuffers[i]);
+    // The meters were published by the last chunk of the block
+    for(size_t i = 0; i < compressors.size(); ++i){
+        const auto& comp = compressors[i];
+        record.bands[i] = {comp.getRMSInputLevelDb(), comp.getPeakInputLevelDb(),
+                           comp.getRMSOutputLevelDb(), comp.getPeakOutputLevelDb(), comp.getGainReductionDb()};
+    }
+}
+
+void SimpleMBCompAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer)
+{
+    // A silent input only has to be checked until it comes back
+    if(updateIdleState(buffer)){
+        buffer.clear();
+        return;
     }
     
-    // Next, we need to sum the two individually processed buffers into a single buffer
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
-    
-    // Clear the input buffer
-    buffer.clear();
+    // Everything below works on block, which is only the first channel while the input is dual mono
+    const auto processAsMono = updateDualMonoState(buffer);
+    auto block = juce::dsp::AudioBlock<float>(buffer);
+    if(processAsMono){
+        block = block.getSubsetChannelBlock(0, 1);
+    }
     
-    // Helper function to add the filter bands
-    auto addFilterBand = [nc = numChannels, ns = numSamples](auto& inputBuffer, const auto& source)
+    const auto numSamples = block.getNumSamples();
+    auto duplicateFirstChannel = [&buffer, processAsMono]()
     {
-        for(auto i = 0; i < nc; ++i){
-            inputBuffer.addFrom(i, 0, source, i, 0, ns);
+        for(int channel = 1; processAsMono && channel < buffer.getNumChannels(); ++channel){
+            buffer.copyFrom(channel, 0, buffer, 0, 0, buffer.getNumSamples());
         }
     };
     
@@ -358,25 +559,187 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         }
     }
     
-    // Add the bands and incorporating mute/solo functionalities
-    if(bandsAreSoloed){
-        for(size_t i = 0; i < compressors.size(); ++i){
-            auto& comp = compressors[i];
-            if(comp.solo -> get()){
-                addFilterBand(buffer, filterBuffers[i]);
+    // Incorporating mute/solo functionalities: a band that is soloed, or unmuted while nothing is soloed, is heard
+    // heardBands lists them from the lowest up, so the sum below only ever touches the bands it adds
+    std::array<bool, NumBands> bandIsHeard {};
+    std::array<size_t, NumBands> heardBands {};
+    size_t numHeardBands = 0;
+    for(size_t i = 0; i < compressors.size(); ++i){
+        auto& comp = compressors[i];
+        bandIsHeard[i] = bandsAreSoloed ? comp.solo -> get() : !comp.mute -> get();
+        if(bandIsHeard[i]){
+            heardBands[numHeardBands++] = i;
+        }
+    }
+    
+    // Passthrough: decide which of the two paths this block needs. Both run while the mix between them is fading
+    passthroughMix.setTargetValue(canPassThrough(bandIsHeard) ? 1.f : 0.f);
+    const auto passthroughRuns = passthroughMix.isSmoothing() || passthroughMix.getCurrentValue() > 0.f;
+    const auto bandsRun = passthroughMix.isSmoothing() || passthroughMix.getCurrentValue() < 1.f;
+    
+    // The path that starts running takes over the crossover state of the other, before either processes this block
+    // Bypass Phase Match is read as the passthrough starts and kept until it stops, so what is heard never jumps
+    // between the allpass and a plain copy, and the allpass never resumes from a state it was not given
+    if(passthroughRuns && !passthroughWasRunning){
+        passthroughMatchesPhase = bypassPhaseMatchParam -> get();
+        if(passthroughMatchesPhase){
+            crossover.startAllpass();
+        }
+        
+        allpassIsCurrent = passthroughMatchesPhase;
+    }
+    
+    if(bandsRun && !bandsWereRunning){
+        // A plain copy leaves the allpass chain behind, so then the split starts again from silence instead
+        if(allpassIsCurrent){
+            crossover.stopAllpass();
+        } else{
+            crossover.reset();
+        }
+    }
+    
+    passthroughWasRunning = passthroughRuns;
+    bandsWereRunning = bandsRun;
+    
+    // The bands overwrite the buffer, so while both paths run the passthrough works on a copy of the input
+    auto passthroughBlock = bandsRun ? passthroughArenaBlock.getSubsetChannelBlock(0, block.getNumChannels()).getSubBlock(0, numSamples)
+                                     : block;
+    if(passthroughRuns){
+        if(bandsRun){
+            passthroughBlock.copyFrom(block);
+        }
+        
+        if(passthroughMatchesPhase){
+            crossover.processAllpass(passthroughBlock);
+        }
+    }
+    
+    if(!bandsRun){
+        // Nothing below runs, so the compressors settle on their bands again once it does
+        for(auto& comp : compressors){
+            comp.skip();
+        }
+        
+        duplicateFirstChannel();
+        return;
+    }
+    
+    // The stages below run over one tile of the block at a time, so each tile goes through the split, the compressors
+    // and the sum while it is still in cache. Every stage carries its state from one tile to the next, so the output
+    // is the same as running each stage over the whole block
+    auto threshold = parallelBandThreshold.load(std::memory_order_relaxed);
+    const auto runInParallel = bandWorkers.isRunning() && threshold > 0 && numSamples >= static_cast<size_t>(threshold);
+    
+    // A band that settles does so on the samples it is given first, so then the block goes through whole
+    auto bandSettles = false;
+    for(size_t i = 0; i < compressors.size(); ++i){
+        bandSettles = bandSettles || (bandIsHeard[i] && compressors[i].isSkipped());
+    }
+    
+    auto samplesPerTile = numSamples;
+    if(auto requestedTileSize = tileSize.load(std::memory_order_relaxed); requestedTileSize > 0 && !runInParallel && !bandSettles){
+        constexpr auto step = static_cast<int>(CompressorKernel<float>::maxControlInterval);
+        samplesPerTile = static_cast<size_t>(juce::jlimit(64, 256, requestedTileSize / step * step));
+    }
+    
+    auto processTile = [&](size_t start, size_t length)
+    {
+        auto tile = block.getSubBlock(start, length);
+        const auto isFirstTile = start == 0;
+        const auto isLastTile = start + length == numSamples;
+        
+        // The gains are constant unless they are ramping, in which case every sample gets its own
+        auto rampGain = [this, length](juce::SmoothedValue<float>& gain, float* ramp, size_t stage) -> const float*
+        {
+            StageTimes::Scope timing(stageTimes, stage);
+            Tracer::Scope trace(stage == StageTimes::InputGain ? "Input gain" : "Output gain");
+            if(!gain.isSmoothing()){
+                return nullptr;
             }
+            
+            for(size_t i = 0; i < length; ++i){
+                ramp[i] = gain.getNextValue();
+            }
+            
+            return ramp;
+        };
+        
+        const auto* inputGains = rampGain(inputGain, gainRamps.getChannelPointer(0), StageTimes::InputGain);
+        const auto* outputGains = rampGain(outputGain, gainRamps.getChannelPointer(1), StageTimes::OutputGain);
+        
+        // Here is the general scheme: First, we filter the input buffer into each band's view of the band arena. We then process each band separately. Finally, we merge the bands.
+        
+        // Split the whole frequency range into the filter bands, applying the input gain before we do any compression
+        {
+            StageTimes::Scope timing(stageTimes, StageTimes::SplitBands);
+            Tracer::Scope trace("Split bands");
+            splitBands(tile, inputGains, inputGain.getTargetValue());
         }
-    } else{
-        for(size_t i = 0; i < compressors.size(); ++i){
-            auto& comp = compressors[i];
-            if(!comp.mute -> get()){
-                addFilterBand(buffer, filterBuffers[i]);
+        
+        // Compress each individual band
+        // Note that the bypass functionality is done within the process function
+        // Bands that are not heard are not compressed at all. The crossover above still ran for them, so their filter
+        // states stay continuous and the band is ready to be heard again on the next block
+        // The bands share no state, so large blocks hand them to the worker pool and join before the sum below
+        auto compressBand = [this, &bandIsHeard, isFirstTile, isLastTile](size_t i)
+        {
+            StageTimes::Scope timing(stageTimes, StageTimes::FirstBand + i);
+            Tracer::Scope trace("Compress band", static_cast<int>(i) + 1);
+            if(bandIsHeard[i]){
+                compressors[i].processTile(filterBuffers[i], isFirstTile, isLastTile);
+            } else{
+                compressors[i].skip();
+            }
+        };
+        
+        if(runInParallel){
+            bandWorkers.parallelFor(filterBuffers.size(), compressBand);
+        } else{
+            for(size_t i = 0; i < filterBuffers.size(); ++i){
+                compressBand(i);
             }
         }
+        
+        // Next, we need to sum the bands that are heard into the buffer, applying the output gain in the same pass
+        // The sum overwrites the tile, so it needs no clearing first
+        {
+            StageTimes::Scope timing(stageTimes, StageTimes::SumBands);
+            Tracer::Scope trace("Sum bands");
+            for(size_t channel = 0; channel < tile.getNumChannels(); ++channel){
+                std::array<const float*, NumBands> bands {};
+                for(size_t i = 0; i < numHeardBands; ++i){
+                    bands[i] = filterBuffers[heardBands[i]].getChannelPointer(channel);
+                }
+                
+                kernels -> sumBands({bands.data(), numHeardBands, length,
+                                     outputGains, outputGain.getTargetValue(),
+                                     tile.getChannelPointer(channel)});
+            }
+        }
+        
+        // Crossfade towards whichever path the mix is heading for
+        if(passthroughRuns){
+            auto* fade = passthroughFade.get();
+            for(size_t i = 0; i < length; ++i){
+                fade[i] = passthroughMix.getNextValue();
+            }
+            
+            auto passthroughTile = passthroughBlock.getSubBlock(start, length);
+            for(size_t channel = 0; channel < tile.getNumChannels(); ++channel){
+                auto* samples = tile.getChannelPointer(channel);
+                const auto* passthrough = passthroughTile.getChannelPointer(channel);
+                for(size_t i = 0; i < length; ++i){
+                    samples[i] += fade[i] * (passthrough[i] - samples[i]);
+                }
+            }
+        }
+    };
+    
+    for(size_t start = 0; start < numSamples; start += samplesPerTile){
+        processTile(start, juce::jmin(samplesPerTile, numSamples - start));
     }
     
-    // Apply output gain after the processing
-    applyGain(buffer, outputGain);
+    duplicateFirstChannel();
 }
 
 //==============================================================================
@@ -428,7 +791,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
     // Adding numeric parameters (Threshold, attack, release, Gain)
     auto gainRange = NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f);
     auto thresholdRange = NormalisableRange<float>(MIN_THRESHOLD, MAX_DECIBELS, 1, 1);
-    auto attackReleaseRange = NormalisableRange<float>(5, 500, 1, 1);
+    // Whole milliseconds over the range the compressors keep a coefficient table for
+    auto attackReleaseRange = NormalisableRange<float>(FastMath::EnvelopeCoefficientTable::MinTimeMs,
+                                                       FastMath::EnvelopeCoefficientTable::MaxTimeMs,
+                                                       1,
+                                                       1);
 
     layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Gain_In), 1},
                                                      params.at(Names::Gain_In),
@@ -439,107 +806,76 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
                                                      gainRange,
                                                      0));
     
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Threshold_Low_Band), 1},
-                                                     params.at(Names::Threshold_Low_Band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Threshold_Mid_Band), 1},
-                                                     params.at(Names::Threshold_Mid_Band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Threshold_High_Band), 1},
-                                                     params.at(Names::Threshold_High_Band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Attack_Low_Band), 1},
-                                                     params.at(Names::Attack_Low_Band),
-                                                     attackReleaseRange,
-                                                     50));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Attack_Mid_Band), 1},
-                                                     params.at(Names::Attack_Mid_Band),
-                                                     attackReleaseRange,
-                                                     50));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Attack_High_Band), 1},
-                                                     params.at(Names::Attack_High_Band),
-                                                     attackReleaseRange,
-                                                     50));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Release_Low_Band), 1},
-                                                     params.at(Names::Release_Low_Band),
-                                                     attackReleaseRange,
-                                                     250));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Release_Mid_Band), 1},
-                                                     params.at(Names::Release_Mid_Band),
-                                                     attackReleaseRange,
-                                                     250));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Release_High_Band), 1},
-                                                     params.at(Names::Release_High_Band),
-                                                     attackReleaseRange,
-                                                     250));
+    // Adding the per-band parameters. Their IDs are generated for NumBands so the layout always matches the processor
+    // Each kind of parameter is added for every band before moving on to the next kind
+    auto addBandParameters = [&layout](BandParam param, int versionHint, auto makeParameter)
+    {
+        for(size_t band = 0; band < NumBands; ++band)
+        {
+            auto paramID = getBandParamID(param, band, NumBands);
+            layout.add(makeParameter(ParameterID {paramID, versionHint}, paramID));
+        }
+    };
+    
+    auto floatParameter = [](const NormalisableRange<float>& range, float defaultValue)
+    {
+        return [range, defaultValue](const ParameterID& paramID, const String& name)
+        {
+            return std::make_unique<AudioParameterFloat>(paramID, name, range, defaultValue);
+        };
+    };
+    
+    auto boolParameter = [](const ParameterID& paramID, const String& name)
+    {
+        return std::make_unique<AudioParameterBool>(paramID, name, false);
+    };
+    
+    addBandParameters(BandParam::Threshold, 1, floatParameter(thresholdRange, 0));
+    addBandParameters(BandParam::Attack, 1, floatParameter(attackReleaseRange, 50));
+    addBandParameters(BandParam::Release, 1, floatParameter(attackReleaseRange, 250));
     
     // Adding threshold choices
     // Note that juce::AudioParameterChoice requires a juce::StringArray as a constructor argument
-    auto choices = std::vector<double> {1, 1.5, 2, 3, 4, 5, 6, 7, 8, 10, 15, 20, 50, 100};
     StringArray sa;
-    for(auto choice : choices){
-        sa.add(String(choice, 1));
+    for(auto choice : RatioChoices){
+        sa.add(String(static_cast<double>(choice), 1));
     }
     // Notice the 3 set as the initial ratio here. This corresponds to the sa element of index 3
-    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {params.at(Names::Ratio_Low_Band), 1},
-                                                      params.at(Names::Ratio_Low_Band),
-                                                      sa,
-                                                      3));
-    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {params.at(Names::Ratio_Mid_Band), 1},
-                                                      params.at(Names::Ratio_Mid_Band),
-                                                      sa,
-                                                      3));
-    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {params.at(Names::Ratio_High_Band), 1},
-                                                      params.at(Names::Ratio_High_Band),
-                                                      sa,
-                                                      3));
-    
-    // Bypass parameters
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Bypassed_Low_Band), 1},
-                                                    params.at(Names::Bypassed_Low_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Bypassed_Mid_Band), 1},
-                                                    params.at(Names::Bypassed_Mid_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Bypassed_High_Band), 1},
-                                                    params.at(Names::Bypassed_High_Band),
-                                                    false));
-    
-    // Mute parameters
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Mute_Low_Band), 1},
-                                                    params.at(Names::Mute_Low_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Mute_Mid_Band), 1},
-                                                    params.at(Names::Mute_Mid_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Mute_High_Band), 1},
-                                                    params.at(Names::Mute_High_Band),
-                                                    false));
-    
-    // Solo parameters
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Solo_Low_Band), 1},
-                                                    params.at(Names::Solo_Low_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Solo_Mid_Band), 1},
-                                                    params.at(Names::Solo_Mid_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Solo_High_Band), 1},
-                                                    params.at(Names::Solo_High_Band),
-                                                    false));
-        
+    addBandParameters(BandParam::Ratio, 1, [&sa](const ParameterID& paramID, const String& name)
+    {
+        return std::make_unique<AudioParameterChoice>(paramID, name, sa, 3);
+    });
+    
+    // Bypass, mute and solo parameters
+    addBandParameters(BandParam::Bypassed, 1, boolParameter);
+    addBandParameters(BandParam::Mute, 1, boolParameter);
+    addBandParameters(BandParam::Solo, 1, boolParameter);
     
     // Crossover frequencies
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Low_Mid_Crossover_Freq), 1},
-                                                     params.at(Names::Low_Mid_Crossover_Freq),
-                                                     NormalisableRange<float>(MIN_FREQUENCY, 999, 1, 1),
-                                                     400));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {params.at(Names::Mid_High_Crossover_Freq), 1},
-                                                     params.at(Names::Mid_High_Crossover_Freq),
-                                                     NormalisableRange<float>(1000, MAX_FREQUENCY, 1, 1),
-                                                     2000));
+    for(size_t i = 0; i < BandCrossover::NumCrossovers; ++i){
+        auto paramID = getCrossoverParamID(i, NumBands);
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {paramID, 1},
+                                                         paramID,
+                                                         getCrossoverRange(i, NumBands),
+                                                         getCrossoverDefault(i, NumBands)));
+    }
+    
+    // Parameters added since the first version go last with a higher version hint, so the ones before them keep
+    // their indices for hosts that automate by index
+    
+    // Soft knee width in dB. 0 is the original hard knee
+    addBandParameters(BandParam::Knee, 2, floatParameter(NormalisableRange<float>(0, 24, 0.1f, 1), 0));
+    
+    // The level detector. The choices follow DSPKernels::Detector
+    addBandParameters(BandParam::Detector, 2, [](const ParameterID& paramID, const String& name)
+    {
+        return std::make_unique<AudioParameterChoice>(paramID, name, StringArray {"Peak", "RMS", "True Peak"}, 0);
+    });
+    
+    // Whether the passthrough keeps the crossover's phase response or is a plain copy of the input
+    layout.add(std::make_unique<AudioParameterBool>(ParameterID {params.at(Names::Bypass_Phase_Match), 2},
+                                                    params.at(Names::Bypass_Phase_Match),
+                                                    true));
     
     return layout;
 }
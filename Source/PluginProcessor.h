@@ -10,7 +10,13 @@
 
 #include <JuceHeader.h>
 #include "DSP/CompressorBand.h"
+#include "DSP/Crossover.h"
 #include "DSP/SingleChannelSampleFifo.h"
+#include "DSP/WorkerPool.h"
+#include "DSP/ParameterSnapshot.h"
+#include "DSP/StageTimer.h"
+#include "DSP/DeadlineMonitor.h"
+#include "DSP/FlightRecorder.h"
 
 /*
  DSP Roadmap
@@ -79,42 +85,136 @@ public:
     SingleChannelSampleFifo<BlockType> leftChannelFifo { Channel::Left };
     SingleChannelSampleFifo<BlockType> rightChannelFifo { Channel::Right };
     
-    // Array of CompressorBand objects
-    std::array<CompressorBand, 3> compressors;
-    CompressorBand& lowBandComp = compressors[0];
-    CompressorBand& midBandComp = compressors[1];
-    CompressorBand& highBandComp = compressors[2];
+    // The number of bands is fixed at compile time. The crossover cascade and the parameter layout are both generated from it
+    static constexpr size_t NumBands = 3;
+    
+    // Array of CompressorBand objects, ordered from the lowest band to the highest
+    std::array<CompressorBand, NumBands> compressors;
+    
+    // The DSP kernels are picked from the instruction sets the CPU supports in prepareToPlay
+    // Forcing one, e.g. DSPKernels::Isa::Scalar for the reference output, takes effect from the next prepareToPlay
+    void setForcedKernelIsa(std::optional<DSPKernels::Isa> isa) { forcedKernelIsa = isa; }
+    DSPKernels::Isa getKernelIsa() const { return kernels -> isa; }
+    
+    // Blocks of at least this many samples compress their bands in parallel on a worker pool, 0 turns it off
+    // The workers are only started by prepareToPlay when the prepared block size reaches the threshold
+    static constexpr int defaultParallelBandThreshold = 2048;
+    void setParallelBandThreshold(int minimumBlockSize) { parallelBandThreshold = minimumBlockSize; }
+    
+    // Blocks are processed in tiles of this many samples, each of which goes through every stage while it is still in
+    // cache. Sizes are rounded to a multiple of CompressorKernel::maxControlInterval and kept to [64, 256]. 0 runs each
+    // stage over the whole block instead, which gives the same output bit for bit
+    static constexpr int defaultTileSize = 256;
+    void setTileSize(int samples) { tileSize = samples; }
+    
+    // Every band runs its gain computer once per this many samples and ramps the gain in between, from the next
+    // block. Intervals are rounded down to 1, 8, 16 or 32, and 1 is audio rate. See CompressorKernel::setControlInterval
+    // for what each costs in accuracy
+    static constexpr int defaultGainControlInterval = 1;
+    void setGainControlInterval(int samples);
+    
+    // Once the input has stayed below this level for longer than the tail (see getTailLengthSeconds), the plugin
+    // goes idle: it only checks the input and writes silence until a sample rises above the floor again
+    static constexpr float defaultSilenceFloorDb = -120.f;
+    void setSilenceFloorDb(float floorDb) { silenceFloorDb = floorDb; }
+    
+    // Channels that carry the same input for longer than the tail are processed once and copied (see dualMono below)
+    // Turning it off processes every channel, e.g. for the reference output, and leaves dual mono on the next block
+    void setDualMonoEnabled(bool shouldBeEnabled) { dualMonoEnabled = shouldBeEnabled; }
+    
+    // Where each block's time goes, stage by stage. Empty unless SIMPLEMBCOMP_STAGE_TIMING is defined (see DSP/StageTimer.h)
+    using StageTimes = StageTimer<NumBands>;
+    StageTimes stageTimes;
+    
+    // How close each block came to its real-time budget, for spotting the blocks that drop out
+    DeadlineMonitor deadlines;
+    
+    // A record of every recent block, levels and gain reduction included, to look at after a pump or a dropout
+    using FlightRecords = FlightRecorder<NumBands>;
+    FlightRecords flightRecorder;
     
 private:
-    using Filter = juce::dsp::LinkwitzRileyFilter<float>;
     // Since filters are constructed through delays, we need to make sure the timing of all bands are the same
-    // The specific scheme is described in the tutorial. It is also roughly shown here visually
-    //     fc0  fc1
-    Filter LP1, AP2,
-           HP1, LP2,
-                HP2;
+    // The crossover generates the LP/HP/allpass cascade that keeps every band phase aligned (see Crossover.h)
+    using BandCrossover = Crossover<NumBands>;
+    BandCrossover crossover;
     
-    juce::AudioParameterFloat* lowMidCrossover {nullptr};
-    juce::AudioParameterFloat* midHighCrossover {nullptr};
+    std::array<juce::AudioParameterFloat*, BandCrossover::NumCrossovers> crossoverFrequencies {};
     
-    // We need to create three separate audio buffers for the each band to correctly handle the multi-band processing
-    // We store the buffers here in the array filterBuffers
-    // Array of AudioBuffer<float> objects
-    std::array<juce::AudioBuffer<float>, 3> filterBuffers;
+    // Every band's channels live back to back in one 64-byte aligned arena that is allocated in prepareToPlay
+    // The filters write straight from the input into it, so no band ever needs a copy of the input buffer
+    // filterBuffers holds the per-band views into the arena, trimmed to the current block size by splitBands
+    static constexpr size_t bandArenaAlignment = 64;
+    juce::HeapBlock<char> bandArena;
+    juce::dsp::AudioBlock<float> bandArenaBlock;
+    BandCrossover::BandBlocks filterBuffers;
     
-    juce::dsp::Gain<float> inputGain, outputGain;
+    std::optional<DSPKernels::Isa> forcedKernelIsa;
+    const DSPKernels::Table* kernels {DSPKernels::Scalar::getTable()};
+    
+    WorkerPool bandWorkers;
+    std::atomic<int> parallelBandThreshold {defaultParallelBandThreshold};
+    std::atomic<int> tileSize {defaultTileSize};
+    
+    // The gains are smoothed here and applied inside the kernels: the input gain as the split reads the input, the
+    // output gain as the bands are summed. gainRamps holds their per-sample values for a tile while they ramp, the
+    // input gain in channel 0 and the output gain in channel 1, each aligned like the band arena
+    static constexpr double gainRampSeconds = 0.05;
+    juce::SmoothedValue<float> inputGain, outputGain;
+    juce::HeapBlock<char> gainRampArena;
+    juce::dsp::AudioBlock<float> gainRamps;
     juce::AudioParameterFloat* inputGainParam {nullptr};
     juce::AudioParameterFloat* outputGainParam {nullptr};
     
-    template<typename T, typename U>
-    void applyGain(T& buffer, U& gain){
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        auto ctx = juce::dsp::ProcessContextReplacing<float>(block);
-        gain.process(ctx);
-    }
+    // The fields of the parameter snapshot: the crossover frequencies, the two gains, then each band's parameters
+    static constexpr size_t inputGainField = BandCrossover::NumCrossovers;
+    static constexpr size_t outputGainField = inputGainField + 1;
+    static constexpr size_t firstBandField = outputGainField + 1;
+    static constexpr size_t numSnapshotFields = firstBandField + NumBands * Params::NumBandParams;
+    
+    // Declared after apvts so that it stops listening before the parameters are destroyed
+    ParameterSnapshot<numSnapshotFields> parameterSnapshot;
+    
+    // With every band bypassed and heard and both gains at 0 dB the bands sum back to the crossover's allpass
+    // response, so the split and the compressors are skipped and only that allpass runs, or a plain copy when
+    // Bypass Phase Match is off. Switching in either direction crossfades the two paths over passthroughFadeSeconds
+    // Bypass Phase Match takes effect the next time the passthrough starts
+    static constexpr double passthroughFadeSeconds = 0.05;
+    juce::AudioParameterBool* bypassPhaseMatchParam {nullptr};
+    juce::SmoothedValue<float> passthroughMix;
+    juce::HeapBlock<char> passthroughArena;
+    juce::dsp::AudioBlock<float> passthroughArenaBlock;
+    juce::HeapBlock<float> passthroughFade;
+    bool passthroughWasRunning {false}, bandsWereRunning {true}, allpassIsCurrent {false}, passthroughMatchesPhase {true};
+    
+    bool canPassThrough(const std::array<bool, NumBands>& bandIsHeard) const;
+    
+    // Silence: the tail is recomputed whenever a parameter or the floor changes, see updateState
+    std::atomic<float> silenceFloorDb {defaultSilenceFloorDb};
+    float idleFloorDb {1.f}, idleFloorGain {0.f};
+    int64_t tailSamples {0}, silentSamples {0};
+    bool idle {false};
+    
+    double calculateTailSeconds(float floorDb) const;
+    bool updateIdleState(const juce::AudioBuffer<float>& buffer);
+    
+    // Dual mono: once every channel has carried the same input for the whole tail, their states agree down to the
+    // silence floor, so only the first channel is processed and the result is copied to the others
+    std::atomic<bool> dualMonoEnabled {true};
+    int64_t identicalSamples {0};
+    bool dualMono {false};
+    
+    bool updateDualMonoState(const juce::AudioBuffer<float>& buffer);
+    
+    // The largest block prepareToPlay allocated for. processBlock hands processChunk no more than this at a time
+    int preparedBlockSize {0};
+    void processChunk(juce::AudioBuffer<float>& buffer);
     
-    void updateState(); 
-    void splitBands(const juce::AudioBuffer<float>& inputBuffer);
+    // Returns whether any parameter had changed since the last block
+    bool updateState();
+    void describeBlock(FlightRecords::Record& record, bool parametersChanged) const;
+    void updateParameter(size_t field);
+    void splitBands(const juce::dsp::AudioBlock<float>& inputBlock, const float* inputGains, float inputGain);
     
     juce::dsp::Oscillator<float> osc;
     juce::dsp::Gain<float> gain;
@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+    Benchmark.cpp
+    Created: 16 Oct 2026 8:20:37pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/DSP/Params.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Benchmark
+{
+namespace
+{
+// Noise peaking at -6 dBFS, which puts every band well above the threshold of the active states
+constexpr float noiseAmplitude = 0.5f;
+constexpr float activeThresholdDb = -36.f;
+
+// The input is read from a loop of this many sample frames, long enough that no block size lines up with it
+constexpr int inputLength = 65537;
+
+// Runs before the timed ones, on top of the tail, to settle the caches and the branch predictors
+constexpr double warmUpSeconds = 0.1;
+
+constexpr std::pair<BandState, const char*> bandStateNames[]
+{
+    { BandState::Active, "active" },
+    { BandState::Soloed, "soloed" },
+    { BandState::Bypassed, "bypassed" },
+    { BandState::Silent, "silent" },
+};
+
+void setParameter(SimpleMBCompAudioProcessor& processor, const juce::String& id, float value)
+{
+    auto* parameter = processor.apvts.getParameter(id);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+void setBandState(SimpleMBCompAudioProcessor& processor, BandState state)
+{
+    using namespace Params;
+    constexpr auto numBands = SimpleMBCompAudioProcessor::NumBands;
+
+    for(size_t band = 0; band < numBands; ++band)
+    {
+        setParameter(processor, getBandParamID(BandParam::Threshold, band, numBands), activeThresholdDb);
+        setParameter(processor, getBandParamID(BandParam::Bypassed, band, numBands), state == BandState::Bypassed ? 1.f : 0.f);
+        setParameter(processor, getBandParamID(BandParam::Solo, band, numBands), state == BandState::Soloed && band == 1 ? 1.f : 0.f);
+    }
+}
+
+juce::AudioBuffer<float> makeInput(const Configuration& configuration)
+{
+    juce::AudioBuffer<float> input(configuration.numChannels, inputLength);
+    input.clear();
+
+    if(configuration.bandState == BandState::Silent)
+        return input;
+
+    // The same noise every time, so two builds are timed on the same samples
+    juce::Random random(0x5eed);
+
+    for(int channel = 0; channel < input.getNumChannels(); ++channel)
+    {
+        auto* samples = input.getWritePointer(channel);
+
+        for(int i = 0; i < inputLength; ++i)
+            samples[i] = noiseAmplitude * (2.f * random.nextFloat() - 1.f);
+    }
+
+    return input;
+}
+
+// The counters have to be read from the thread they were opened on, so this only works with the bands compressed
+// on the calling thread
+template<typename ReadNextBlock>
+EventCounts countEvents(SimpleMBCompAudioProcessor& processor, ReadNextBlock&& readNextBlock, int numBlocks, int blockSize)
+{
+    PerfCounters counters;
+    juce::MidiBuffer midi;
+    EventCounts events;
+
+    const auto numSamples = static_cast<double>(numBlocks) * blockSize;
+    auto toPerSample = [numSamples](PerfCounters::Counts counts)
+    {
+        for(auto& count : counts)
+            if(count.has_value())
+                *count /= numSamples;
+
+        return counts;
+    };
+
+    processor.setParallelBandThreshold(0);
+
+    counters.reset();
+
+    for(int block = 0; block < numBlocks; ++block)
+    {
+        auto& buffer = readNextBlock();
+
+        counters.start();
+        processor.processBlock(buffer, midi);
+        counters.stop();
+    }
+
+    events.perSample = toPerSample(counters.getCounts());
+
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    using StageTimes = SimpleMBCompAudioProcessor::StageTimes;
+
+    for(size_t stage = 0; stage < StageTimes::NumStages; ++stage)
+        events.perStage.emplace_back(StageTimes::getStageName(stage), PerfCounters::Counts {});
+
+    // One counter at a time, so it never has to share the CPU's registers and its raw count is exact
+    for(int counter = 0; counter < PerfCounters::NumCounters; ++counter)
+    {
+        if(! counters.isAvailable(static_cast<PerfCounters::Counter>(counter)))
+            continue;
+
+        struct Source
+        {
+            PerfCounters& counters;
+            PerfCounters::Counter counter;
+        };
+
+        Source source { counters, static_cast<PerfCounters::Counter>(counter) };
+        StageTiming::tickSource = { [](void* context) noexcept
+                                    {
+                                        auto& source = *static_cast<Source*>(context);
+                                        return source.counters.read(source.counter);
+                                    }, &source };
+
+        std::array<uint64_t, StageTimes::NumStages> before;
+        for(size_t stage = 0; stage < StageTimes::NumStages; ++stage)
+            before[stage] = processor.stageTimes.getStatistics(stage).totalTicks;
+
+        counters.start(source.counter);
+
+        for(int block = 0; block < numBlocks; ++block)
+            processor.processBlock(readNextBlock(), midi);
+
+        counters.stop();
+        StageTiming::tickSource = {};
+
+        for(size_t stage = 0; stage < StageTimes::NumStages; ++stage)
+        {
+            const auto count = processor.stageTimes.getStatistics(stage).totalTicks - before[stage];
+            events.perStage[stage].second[static_cast<size_t>(counter)] = static_cast<double>(count) / numSamples;
+        }
+    }
+   #endif
+
+    return events;
+}
+}
+
+juce::String getBandStateName(BandState state)
+{
+    for(const auto& [candidate, name] : bandStateNames)
+        if(candidate == state)
+            return name;
+
+    jassertfalse;
+    return {};
+}
+
+std::optional<BandState> getBandState(const juce::String& name)
+{
+    for(const auto& [state, candidate] : bandStateNames)
+        if(name.equalsIgnoreCase(candidate))
+            return state;
+
+    return {};
+}
+
+juce::String Configuration::getName() const
+{
+    return juce::String(numChannels) + "ch/" + juce::String(juce::roundToInt(sampleRate)) + "/"
+         + juce::String(blockSize) + "/" + getBandStateName(bandState);
+}
+
+Result run(const Configuration& configuration, const Settings& settings)
+{
+    SimpleMBCompAudioProcessor processor;
+
+    const auto channelSet = configuration.numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    const auto layoutIsSupported = processor.setBusesLayout(layout);
+    jassert(layoutIsSupported);
+    juce::ignoreUnused(layoutIsSupported);
+
+    if(settings.isa.has_value())
+        processor.setForcedKernelIsa(settings.isa);
+
+    if(settings.tileSize.has_value())
+        processor.setTileSize(*settings.tileSize);
+
+    if(settings.gainControlInterval.has_value())
+        processor.setGainControlInterval(*settings.gainControlInterval);
+
+    setBandState(processor, configuration.bandState);
+
+    const auto blockSize = configuration.blockSize;
+    processor.setRateAndBufferSizeDetails(configuration.sampleRate, blockSize);
+    processor.prepareToPlay(configuration.sampleRate, blockSize);
+
+    const auto input = makeInput(configuration);
+    juce::AudioBuffer<float> buffer(configuration.numChannels, blockSize);
+    juce::MidiBuffer midi;
+    int position = 0;
+
+    auto readNextBlock = [&]() -> juce::AudioBuffer<float>&
+    {
+        if(position + blockSize > inputLength)
+            position = 0;
+
+        for(int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.copyFrom(channel, 0, input, channel, position, blockSize);
+
+        position += blockSize;
+        return buffer;
+    };
+
+    auto toBlocks = [&](double seconds)
+    {
+        return juce::jmax(1, static_cast<int>(std::ceil(seconds * configuration.sampleRate / blockSize)));
+    };
+
+    for(int block = toBlocks(processor.getTailLengthSeconds() + warmUpSeconds); --block >= 0;)
+    {
+        readNextBlock();
+        processor.processBlock(buffer, midi);
+    }
+
+    const auto blocksPerRun = toBlocks(settings.secondsPerRun);
+    std::vector<double> nsPerSample;
+
+    for(int run = 0; run < juce::jmax(1, settings.numRuns); ++run)
+    {
+        std::chrono::steady_clock::duration elapsed {};
+
+        for(int block = 0; block < blocksPerRun; ++block)
+        {
+            readNextBlock();
+
+            const auto start = std::chrono::steady_clock::now();
+            processor.processBlock(buffer, midi);
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+
+        nsPerSample.push_back(std::chrono::duration<double, std::nano>(elapsed).count()
+                              / (static_cast<double>(blocksPerRun) * blockSize));
+    }
+
+    std::optional<EventCounts> events;
+
+    if(settings.countEvents)
+        events = countEvents(processor, readNextBlock, blocksPerRun * juce::jmax(1, settings.numRuns), blockSize);
+
+    processor.releaseResources();
+
+    std::sort(nsPerSample.begin(), nsPerSample.end());
+    const auto median = nsPerSample[nsPerSample.size() / 2];
+
+    Result result;
+    result.configuration = configuration;
+    result.isa = processor.getKernelIsa();
+    result.nsPerSample = median;
+    result.realtimeFactor = 1.0e9 / (median * configuration.sampleRate);
+    result.megasamplesPerSecond = 1.0e3 / median;
+    result.events = std::move(events);
+    return result;
+}
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 16 Oct 2026 8:20:37pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/DSPKernels.h"
+#include "PerfCounters.h"
+
+#include <optional>
+#include <vector>
+
+/*
+ Times SimpleMBCompAudioProcessor::processBlock on one configuration at a time, without an editor or a host
+
+ Every configuration gets a fresh processor, prepared for exactly its block size. It is run past its tail first, so
+ the silent state has gone idle and every smoothed value has settled, and then timed over several runs of the same
+ length. The median run is reported, which keeps a single preempted run from reading as a regression. Only the
+ processBlock calls are timed, not the copy of the next input block in front of each one.
+
+ With Settings::countEvents the timed runs are followed by as many blocks again under the hardware counters (see
+ PerfCounters.h), so the counters never slow down the timed blocks. The counters only follow the calling thread, so
+ those blocks compress the bands on it rather than on the worker pool. In builds with SIMPLEMBCOMP_STAGE_TIMING (the
+ Counters configuration of the Linux makefile) every counter then gets one more pass of its own, counted per stage by
+ the processor's StageTimer, which reads the counter in place of the cycle counter.
+ */
+namespace Benchmark
+{
+// What the bands are doing while they are timed
+enum class BandState
+{
+    Active,     // noise well above every threshold, so all three bands compress
+    Soloed,     // the same input with the mid band soloed
+    Bypassed,   // every band bypassed, which leaves only the passthrough path
+    Silent,     // digital silence, long enough that the processor has gone idle
+};
+
+juce::String getBandStateName(BandState state);
+std::optional<BandState> getBandState(const juce::String& name);
+
+struct Configuration
+{
+    int blockSize;
+    double sampleRate;
+    int numChannels;
+    BandState bandState;
+
+    // Identifies the configuration in the JSON results, e.g. "2ch/48000/512/active"
+    juce::String getName() const;
+};
+
+struct Settings
+{
+    // The processor's own pick when not set
+    std::optional<DSPKernels::Isa> isa;
+    std::optional<int> tileSize;
+    std::optional<int> gainControlInterval;
+
+    double secondsPerRun = 0.25;
+    int numRuns = 5;
+
+    // Count hardware events as well, see above
+    bool countEvents = false;
+};
+
+// Hardware events per sample frame, for the whole of processBlock and for each of its stages
+struct EventCounts
+{
+    PerfCounters::Counts perSample;
+
+    // In the order the stages run. Empty unless the build defines SIMPLEMBCOMP_STAGE_TIMING
+    std::vector<std::pair<juce::String, PerfCounters::Counts>> perStage;
+};
+
+struct Result
+{
+    Configuration configuration;
+    DSPKernels::Isa isa;
+
+    // Per sample frame, i.e. every channel of one sample
+    double nsPerSample;
+
+    // How many times faster than real time, and the sample frames processed per second
+    double realtimeFactor;
+    double megasamplesPerSecond;
+
+    // Only with Settings::countEvents
+    std::optional<EventCounts> events;
+};
+
+Result run(const Configuration& configuration, const Settings& settings);
+}
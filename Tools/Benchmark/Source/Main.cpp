@@ -0,0 +1,325 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 16 Oct 2026 8:20:37pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+
+#include <iostream>
+#include <map>
+
+/*
+ Headless processBlock benchmark
+
+ Build Benchmark.jucer (Projucer --resave, then make CONFIG=Release in Builds/LinuxMakefile, or the Xcode project)
+ and run it from a quiet machine. Every combination of the lists below is timed (see Benchmark.h) and printed as
+ ns per sample frame and as a multiple of real time.
+
+ Options:
+     --block-sizes 16,32,...   16 to 4096 in powers of two by default
+     --sample-rates 44100,...  44100, 48000, 96000 and 192000 by default
+     --channels 1,2            both by default
+     --states active,...       active, soloed, bypassed and silent by default
+     --quick                   block sizes 64, 512 and 4096 at 48 kHz in stereo, for a check during development
+     --isa NAME                force the Scalar, SSE2, AVX2 or AVX512 kernels
+     --tile N                  the processor's tile size, 0 for untiled
+     --control-interval N      run the gain computers every N samples: 1 (audio rate, the default), 8, 16 or 32
+     --seconds S               audio per timed run, 0.25 by default
+     --runs N                  timed runs per configuration, of which the median is kept, 5 by default
+     --output FILE             write the results as JSON
+     --baseline FILE           compare against the JSON of an earlier run
+     --threshold PERCENT       how much slower than the baseline a configuration may be, 10 by default
+     --counters                count cycles, instructions, cache and branch misses per sample as well (Linux only).
+                               Built as CONFIG=Counters (BenchmarkCounters), they are broken down by processBlock
+                               stage too
+
+ Exits with 1 when any configuration is slower than the baseline by more than the threshold, and with 2 when the
+ arguments or the baseline cannot be read. Configurations missing from the baseline are listed but not failed.
+ */
+
+namespace
+{
+const juce::String usage = "Usage: Benchmark [--quick] [--block-sizes N,...] [--sample-rates N,...] [--channels N,...]\n"
+                           "                 [--states active,soloed,bypassed,silent] [--isa NAME] [--tile N]\n"
+                           "                 [--control-interval N] [--seconds S] [--runs N] [--output FILE] [--baseline FILE]\n"
+                           "                 [--threshold PERCENT] [--counters]";
+
+juce::StringArray splitList(const juce::String& list)
+{
+    return juce::StringArray::fromTokens(list, ",", {});
+}
+
+juce::var toJson(const PerfCounters::Counts& counts)
+{
+    auto* object = new juce::DynamicObject();
+
+    for(int counter = 0; counter < PerfCounters::NumCounters; ++counter)
+        if(const auto& count = counts[static_cast<size_t>(counter)])
+            object->setProperty(PerfCounters::getName(static_cast<PerfCounters::Counter>(counter)), *count);
+
+    return object;
+}
+
+// e.g. "cycles 512.3  instructions 901.0  ipc 1.76  ..." with the counts per sample frame
+juce::String toString(const PerfCounters::Counts& counts)
+{
+    juce::String text;
+
+    for(int counter = 0; counter < PerfCounters::NumCounters; ++counter)
+        if(const auto& count = counts[static_cast<size_t>(counter)])
+            text << PerfCounters::getName(static_cast<PerfCounters::Counter>(counter)) << " " << juce::String(*count, 2) << "  ";
+
+    const auto& cycles = counts[PerfCounters::Cycles];
+    const auto& instructions = counts[PerfCounters::Instructions];
+
+    if(cycles.has_value() && instructions.has_value() && *cycles > 0.0)
+        text << "ipc " << juce::String(*instructions / *cycles, 2);
+
+    return text.trimEnd();
+}
+
+juce::var toJson(const Benchmark::Result& result)
+{
+    auto* object = new juce::DynamicObject();
+    const auto& configuration = result.configuration;
+
+    object->setProperty("name", configuration.getName());
+    object->setProperty("isa", DSPKernels::getIsaName(result.isa));
+    object->setProperty("blockSize", configuration.blockSize);
+    object->setProperty("sampleRate", configuration.sampleRate);
+    object->setProperty("channels", configuration.numChannels);
+    object->setProperty("bandState", Benchmark::getBandStateName(configuration.bandState));
+    object->setProperty("nsPerSample", result.nsPerSample);
+    object->setProperty("realtimeFactor", result.realtimeFactor);
+    object->setProperty("megasamplesPerSecond", result.megasamplesPerSecond);
+
+    if(result.events.has_value())
+    {
+        auto* stages = new juce::DynamicObject();
+
+        for(const auto& [stage, counts] : result.events->perStage)
+            stages->setProperty(stage, toJson(counts));
+
+        auto* counters = new juce::DynamicObject();
+        counters->setProperty("perSample", toJson(result.events->perSample));
+        counters->setProperty("perStage", stages);
+        object->setProperty("counters", counters);
+    }
+
+    return object;
+}
+
+juce::var toJson(const juce::Array<Benchmark::Result>& results, const Benchmark::Settings& settings)
+{
+    juce::Array<juce::var> resultArray;
+
+    for(const auto& result : results)
+        resultArray.add(toJson(result));
+
+    auto* object = new juce::DynamicObject();
+    object->setProperty("cpu", juce::SystemStats::getCpuModel());
+    object->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    object->setProperty("secondsPerRun", settings.secondsPerRun);
+    object->setProperty("runs", settings.numRuns);
+    object->setProperty("results", resultArray);
+
+    return object;
+}
+
+// Returns the number of regressions
+int compareWithBaseline(const juce::Array<Benchmark::Result>& results, const juce::var& baseline, double thresholdPercent)
+{
+    std::map<juce::String, const juce::var*> baselineResults;
+
+    if(auto* baselineArray = baseline["results"].getArray())
+        for(const auto& entry : *baselineArray)
+            baselineResults[entry["name"].toString()] = &entry;
+
+    int numRegressions = 0;
+
+    std::cout << "\nAgainst the baseline (" << baseline["date"].toString() << ", " << baseline["cpu"].toString() << "):\n";
+
+    for(const auto& result : results)
+    {
+        const auto name = result.configuration.getName();
+        const auto found = baselineResults.find(name);
+
+        if(found == baselineResults.end())
+        {
+            std::cout << "  " << name << ": not in the baseline\n";
+            continue;
+        }
+
+        const auto& entry = *found->second;
+        const auto baselineNs = static_cast<double>(entry["nsPerSample"]);
+        const auto changePercent = 100.0 * (result.nsPerSample / baselineNs - 1.0);
+        const auto isRegression = changePercent > thresholdPercent;
+        numRegressions += isRegression ? 1 : 0;
+
+        std::cout << "  " << name << ": " << juce::String(baselineNs, 2) << " -> " << juce::String(result.nsPerSample, 2)
+                  << " ns (" << (changePercent >= 0.0 ? "+" : "") << juce::String(changePercent, 1) << "%)"
+                  << (isRegression ? "  REGRESSION" : "");
+
+        if(entry["isa"].toString() != DSPKernels::getIsaName(result.isa))
+            std::cout << "  [baseline ran " << entry["isa"].toString() << "]";
+
+        std::cout << "\n";
+    }
+
+    return numRegressions;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::StringArray arguments(argv + 1, argc - 1);
+
+    auto getOption = [&arguments](const juce::String& name, const juce::String& defaultValue)
+    {
+        const auto index = arguments.indexOf(name);
+        return index >= 0 && index + 1 < arguments.size() ? arguments[index + 1] : defaultValue;
+    };
+
+    const auto quick = arguments.contains("--quick");
+    const auto blockSizes = splitList(getOption("--block-sizes", quick ? "64,512,4096" : "16,32,64,128,256,512,1024,2048,4096"));
+    const auto sampleRates = splitList(getOption("--sample-rates", quick ? "48000" : "44100,48000,96000,192000"));
+    const auto channelCounts = splitList(getOption("--channels", quick ? "2" : "1,2"));
+    const auto stateNames = splitList(getOption("--states", "active,soloed,bypassed,silent"));
+
+    Benchmark::Settings settings;
+    settings.secondsPerRun = getOption("--seconds", "0.25").getDoubleValue();
+    settings.numRuns = getOption("--runs", "5").getIntValue();
+
+    settings.countEvents = arguments.contains("--counters");
+
+    if(settings.countEvents)
+    {
+        PerfCounters counters;
+
+        if(! counters.isAnyAvailable())
+        {
+            std::cerr << "No hardware counters: " << counters.getError() << "\n";
+            return 2;
+        }
+
+        if(counters.getError().isNotEmpty())
+            std::cerr << "Some hardware counters are missing. The first: " << counters.getError() << "\n";
+    }
+
+    if(arguments.contains("--tile"))
+        settings.tileSize = getOption("--tile", {}).getIntValue();
+
+    if(arguments.contains("--control-interval"))
+        settings.gainControlInterval = getOption("--control-interval", {}).getIntValue();
+
+    if(arguments.contains("--isa"))
+    {
+        const auto isaName = getOption("--isa", {});
+
+        for(auto isa : { DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512 })
+            if(isaName.equalsIgnoreCase(DSPKernels::getIsaName(isa)))
+                settings.isa = isa;
+
+        if(! settings.isa.has_value() || ! DSPKernels::isSupported(*settings.isa))
+        {
+            std::cerr << "Unknown or unsupported instruction set: " << isaName << "\n";
+            return 2;
+        }
+    }
+
+    juce::Array<Benchmark::BandState> states;
+
+    for(const auto& name : stateNames)
+    {
+        if(auto state = Benchmark::getBandState(name))
+            states.add(*state);
+        else
+        {
+            std::cerr << "Unknown band state: " << name << "\n" << usage << "\n";
+            return 2;
+        }
+    }
+
+    juce::var baseline;
+    const auto baselinePath = getOption("--baseline", {});
+
+    if(baselinePath.isNotEmpty())
+    {
+        baseline = juce::JSON::parse(juce::File::getCurrentWorkingDirectory().getChildFile(baselinePath));
+
+        if(baseline["results"].getArray() == nullptr)
+        {
+            std::cerr << "Could not read the baseline " << baselinePath << "\n";
+            return 2;
+        }
+    }
+
+    // The parameter tree needs the message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::Array<Benchmark::Result> results;
+
+    for(const auto& channels : channelCounts)
+        for(const auto& sampleRate : sampleRates)
+            for(const auto& blockSize : blockSizes)
+                for(auto state : states)
+                {
+                    const Benchmark::Configuration configuration { blockSize.getIntValue(), sampleRate.getDoubleValue(),
+                                                                   channels.getIntValue(), state };
+
+                    if(configuration.blockSize <= 0 || configuration.sampleRate <= 0.0
+                       || configuration.numChannels < 1 || configuration.numChannels > 2)
+                    {
+                        std::cerr << "Invalid configuration: " << configuration.getName() << "\n" << usage << "\n";
+                        return 2;
+                    }
+
+                    const auto result = Benchmark::run(configuration, settings);
+                    results.add(result);
+
+                    std::cout << configuration.getName().paddedRight(' ', 24) << DSPKernels::getIsaName(result.isa).paddedRight(' ', 8)
+                              << juce::String(result.nsPerSample, 2).paddedLeft(' ', 9) << " ns/sample"
+                              << juce::String(result.realtimeFactor, 1).paddedLeft(' ', 9) << "x real time" << std::endl;
+
+                    if(result.events.has_value())
+                    {
+                        std::cout << "    per sample: " << toString(result.events->perSample) << "\n";
+
+                        for(const auto& [stage, counts] : result.events->perStage)
+                            std::cout << "    " << (stage + ":").paddedRight(' ', 15) << toString(counts) << "\n";
+
+                        std::cout << std::flush;
+                    }
+                }
+
+    const auto outputPath = getOption("--output", {});
+
+    if(outputPath.isNotEmpty())
+    {
+        const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+
+        if(! outputFile.replaceWithText(juce::JSON::toString(toJson(results, settings))))
+        {
+            std::cerr << "Could not write " << outputPath << "\n";
+            return 2;
+        }
+    }
+
+    if(baseline.isVoid())
+        return 0;
+
+    const auto thresholdPercent = getOption("--threshold", "10").getDoubleValue();
+    const auto numRegressions = compareWithBaseline(results, baseline, thresholdPercent);
+
+    std::cout << numRegressions << " of " << results.size() << " configurations regressed by more than "
+              << thresholdPercent << "%" << std::endl;
+
+    return numRegressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    PerfCounters.cpp
+    Created: 16 Oct 2026 11:02:45pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "PerfCounters.h"
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <cstring>
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+#if JUCE_LINUX
+perf_event_attr getAttributes(PerfCounters::Counter counter)
+{
+    perf_event_attr attributes {};
+    attributes.size = sizeof(attributes);
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    auto setCacheEvent = [&attributes](uint64_t cache)
+    {
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    };
+
+    attributes.type = PERF_TYPE_HARDWARE;
+
+    switch(counter)
+    {
+        case PerfCounters::Cycles: attributes.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PerfCounters::Instructions: attributes.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PerfCounters::L1DataMisses: setCacheEvent(PERF_COUNT_HW_CACHE_L1D); break;
+        case PerfCounters::LastLevelMisses: attributes.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case PerfCounters::BranchMisses: attributes.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case PerfCounters::NumCounters:
+        default: jassertfalse; break;
+    }
+
+    return attributes;
+}
+#endif
+}
+
+PerfCounters::PerfCounters()
+{
+    fileDescriptors.fill(-1);
+
+   #if JUCE_LINUX
+    for(int counter = 0; counter < NumCounters; ++counter)
+    {
+        auto attributes = getAttributes(static_cast<Counter>(counter));
+
+        // This thread only, on whichever CPU it runs
+        fileDescriptors[static_cast<size_t>(counter)] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+
+        if(fileDescriptors[static_cast<size_t>(counter)] < 0 && error.isEmpty())
+            error = juce::String(getName(static_cast<Counter>(counter))) + ": " + std::strerror(errno);
+    }
+   #else
+    error = "Hardware counters are only read on Linux";
+   #endif
+}
+
+PerfCounters::~PerfCounters()
+{
+   #if JUCE_LINUX
+    for(auto fileDescriptor : fileDescriptors)
+        if(fileDescriptor >= 0)
+            close(fileDescriptor);
+   #endif
+}
+
+const char* PerfCounters::getName(Counter counter)
+{
+    switch(counter)
+    {
+        case Cycles: return "cycles";
+        case Instructions: return "instructions";
+        case L1DataMisses: return "l1d_misses";
+        case LastLevelMisses: return "llc_misses";
+        case BranchMisses: return "branch_misses";
+        case NumCounters:
+        default: jassertfalse; return "";
+    }
+}
+
+bool PerfCounters::isAvailable(Counter counter) const
+{
+    return fileDescriptors[static_cast<size_t>(counter)] >= 0;
+}
+
+bool PerfCounters::isAnyAvailable() const
+{
+    for(int counter = 0; counter < NumCounters; ++counter)
+        if(isAvailable(static_cast<Counter>(counter)))
+            return true;
+
+    return false;
+}
+
+bool PerfCounters::read(size_t counter, Reading& reading) const noexcept
+{
+   #if JUCE_LINUX
+    // Laid out the way PERF_FORMAT_TOTAL_TIME_ENABLED and PERF_FORMAT_TOTAL_TIME_RUNNING have the kernel write it
+    static_assert(sizeof(Reading) == 3 * sizeof(uint64_t));
+    return fileDescriptors[counter] >= 0 && ::read(fileDescriptors[counter], &reading, sizeof(reading)) == sizeof(reading);
+   #else
+    juce::ignoreUnused(counter, reading);
+    return false;
+   #endif
+}
+
+void PerfCounters::reset()
+{
+    for(size_t counter = 0; counter < readingsAtReset.size(); ++counter)
+        if(! read(counter, readingsAtReset[counter]))
+            readingsAtReset[counter] = {};
+}
+
+void PerfCounters::start()
+{
+   #if JUCE_LINUX
+    for(auto fileDescriptor : fileDescriptors)
+        if(fileDescriptor >= 0)
+            ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+   #endif
+}
+
+void PerfCounters::start(Counter only)
+{
+   #if JUCE_LINUX
+    if(const auto fileDescriptor = fileDescriptors[static_cast<size_t>(only)]; fileDescriptor >= 0)
+        ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+   #else
+    juce::ignoreUnused(only);
+   #endif
+}
+
+void PerfCounters::stop()
+{
+   #if JUCE_LINUX
+    for(auto fileDescriptor : fileDescriptors)
+        if(fileDescriptor >= 0)
+            ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+   #endif
+}
+
+PerfCounters::Counts PerfCounters::getCounts() const
+{
+    Counts counts;
+
+    for(size_t counter = 0; counter < counts.size(); ++counter)
+    {
+        Reading reading;
+
+        if(! read(counter, reading))
+            continue;
+
+        const auto& atReset = readingsAtReset[counter];
+        const auto timeEnabled = static_cast<double>(reading.timeEnabled - atReset.timeEnabled);
+        const auto timeRunning = static_cast<double>(reading.timeRunning - atReset.timeRunning);
+
+        // A counter that only ran for part of the time it was enabled is scaled up to all of it
+        if(timeRunning > 0.0)
+            counts[counter] = static_cast<double>(reading.value - atReset.value) * timeEnabled / timeRunning;
+    }
+
+    return counts;
+}
+
+uint64_t PerfCounters::read(Counter counter) const noexcept
+{
+    Reading reading;
+    return read(static_cast<size_t>(counter), reading) ? reading.value : 0;
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    PerfCounters.h
+    Created: 16 Oct 2026 11:02:45pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <optional>
+
+/*
+ The CPU's hardware event counters for the calling thread, through Linux perf_event_open
+
+ Only user space is counted, so the kernel's share of a read or a page fault does not show up in the counts. Each
+ counter is opened on its own rather than as a group, so a CPU or virtual machine that lacks one of them still gives
+ the others. When more counters run than the CPU has registers for, the kernel takes turns between them and getCounts
+ scales every count up to the whole interval. Opening fails without the right perf_event_paranoid setting (at most 2
+ for user space counts) or outside Linux, in which case isAvailable is false for every counter.
+ */
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        L1DataMisses,       // L1 data cache read misses
+        LastLevelMisses,    // the kernel's generic cache misses, which are last level cache misses on most CPUs
+        BranchMisses,
+        NumCounters
+    };
+
+    // Per counter, empty for a counter that could not be opened or never got to run
+    using Counts = std::array<std::optional<double>, NumCounters>;
+
+    PerfCounters();
+    ~PerfCounters();
+
+    // The name used in the printed results and the JSON, e.g. "l1d_misses"
+    static const char* getName(Counter counter);
+
+    bool isAvailable(Counter counter) const;
+    bool isAnyAvailable() const;
+
+    // Why the first counter that failed to open did so
+    juce::String getError() const { return error; }
+
+    // The counters start out stopped and at zero. Stopping and starting again keeps adding to the counts
+    void reset();
+    void start();
+    void start(Counter only);
+    void stop();
+
+    // What the counters counted since the last reset
+    Counts getCounts() const;
+
+    // The running count of one counter, not scaled. Only exact while that counter runs alone, see start(Counter)
+    uint64_t read(Counter counter) const noexcept;
+
+private:
+    // A reset does not zero the times a counter was enabled and running, so every reading is taken relative to the
+    // one at the last reset instead
+    struct Reading
+    {
+        uint64_t value = 0;
+        uint64_t timeEnabled = 0;
+        uint64_t timeRunning = 0;
+    };
+
+    std::array<int, NumCounters> fileDescriptors;
+    std::array<Reading, NumCounters> readingsAtReset;
+    juce::String error;
+
+    bool read(size_t counter, Reading& reading) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(PerfCounters)
+};
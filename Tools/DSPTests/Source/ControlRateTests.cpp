@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    ControlRateTests.cpp
+    Created: 17 Oct 2026 11:26:52am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/CompressorKernel.h"
+
+/*
+ Measures the error table in CompressorKernel::setControlInterval and fails if any entry grows
+
+ Every attack time of the table is run at audio rate and at each control interval on the signal the table describes,
+ and the outputs are compared sample by sample. The signal comes from its own generator rather than the runner's
+ seed, so the table is the same on every run. The measured table is logged in the layout of the comment.
+ */
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr size_t blockSize = 512;
+constexpr int numChannels = 2;
+constexpr int numSamples = 4 * static_cast<int>(sampleRate);
+
+// Gain errors are only measured where the input is above -60 dBFS, where the output is far from rounding noise
+constexpr float gainErrorFloor = 0.001f;
+
+// A 220 Hz sine with white noise 20 dB below it, stepping between -26 and -6 dBFS every half second
+juce::AudioBuffer<float> makeSignal()
+{
+    juce::AudioBuffer<float> signal(numChannels, numSamples);
+    std::mt19937 noise(1);
+    const auto samplesPerStep = static_cast<int>(sampleRate / 2);
+
+    for(int i = 0; i < numSamples; ++i)
+    {
+        const auto level = juce::Decibels::decibelsToGain((i / samplesPerStep) % 2 == 0 ? -26.0f : -6.0f);
+        const auto sine = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 220.0 * i / sampleRate));
+
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto white = 2.0f * static_cast<float>(noise() >> 8) / 16777216.0f - 1.0f;
+            signal.setSample(channel, i, level * (sine + 0.1f * white));
+        }
+    }
+
+    return signal;
+}
+
+// The settings of the table: peak detector, threshold -30 dB, ratio 5, 6 dB knee, 100 ms release
+juce::AudioBuffer<float> compress(const juce::AudioBuffer<float>& input, float attackMs, size_t controlInterval)
+{
+    CompressorKernel<float> compressor;
+    compressor.prepare({sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels)},
+                       DSPKernels::getTable(DSPKernels::Isa::Scalar));
+    compressor.setDetector(DSPKernels::Detector::Peak);
+    compressor.setThreshold(-30.0f);
+    compressor.setRatio(5.0f);
+    compressor.setKnee(6.0f);
+    compressor.setAttack(attackMs);
+    compressor.setRelease(100.0f);
+    compressor.setControlInterval(controlInterval);
+
+    auto output = input;
+    for(size_t start = 0; start < static_cast<size_t>(numSamples); start += blockSize)
+    {
+        auto block = juce::dsp::AudioBlock<float>(output).getSubBlock(start, std::min(blockSize, static_cast<size_t>(numSamples) - start));
+        compressor.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    return output;
+}
+
+// One entry of the table
+struct Error
+{
+    float output;       // the largest output error, as a fraction of the audio rate output's peak
+    float maxGainDb;    // the largest gain error in dB
+    float meanGainDb;   // the mean gain error in dB
+};
+
+Error measure(const juce::AudioBuffer<float>& input, const juce::AudioBuffer<float>& audioRate, const juce::AudioBuffer<float>& controlRate)
+{
+    double peak = 0, outputError = 0, maxGainError = 0, sumOfGainErrors = 0;
+    int numGainErrors = 0;
+
+    for(int channel = 0; channel < numChannels; ++channel)
+    {
+        for(int i = 0; i < numSamples; ++i)
+        {
+            const double expected = audioRate.getSample(channel, i);
+            const double actual = controlRate.getSample(channel, i);
+            peak = std::max(peak, std::abs(expected));
+            outputError = std::max(outputError, std::abs(actual - expected));
+
+            if(std::abs(input.getSample(channel, i)) > gainErrorFloor)
+            {
+                const auto gainError = std::abs(20.0 * std::log10(actual / expected));
+                maxGainError = std::max(maxGainError, gainError);
+                sumOfGainErrors += gainError;
+                ++numGainErrors;
+            }
+        }
+    }
+
+    return {static_cast<float>(outputError / peak), static_cast<float>(maxGainError),
+            static_cast<float>(sumOfGainErrors / numGainErrors)};
+}
+
+// The table as documented in CompressorKernel::setControlInterval, one row per attack time
+constexpr float attackTimesMs[] {5, 10, 20, 50, 100, 200, 500};
+constexpr size_t controlIntervals[] {8, 16, 32};
+
+constexpr Error documentedErrors[std::size(attackTimesMs)][std::size(controlIntervals)]
+{
+    {{0.041f, 0.39f, 0.0036f}, {0.081f, 1.14f, 0.0099f}, {0.115f, 1.31f, 0.0312f}},
+    {{0.021f, 0.28f, 0.0028f}, {0.050f, 0.75f, 0.0084f}, {0.107f, 1.18f, 0.0283f}},
+    {{0.011f, 0.19f, 0.0021f}, {0.027f, 0.46f, 0.0068f}, {0.081f, 0.96f, 0.0242f}},
+    {{0.005f, 0.08f, 0.0015f}, {0.012f, 0.19f, 0.0051f}, {0.049f, 0.61f, 0.0186f}},
+    {{0.003f, 0.03f, 0.0011f}, {0.008f, 0.09f, 0.0040f}, {0.022f, 0.30f, 0.0145f}},
+    {{0.001f, 0.02f, 0.0008f}, {0.004f, 0.05f, 0.0031f}, {0.012f, 0.15f, 0.0108f}},
+    {{0.000f, 0.02f, 0.0006f}, {0.001f, 0.03f, 0.0021f}, {0.004f, 0.08f, 0.0071f}},
+};
+
+// Each entry is printed rounded, so the measurement may exceed it by up to half of its last digit
+bool isWithin(float measured, float documented, float lastDigit)
+{
+    return measured < documented + 0.5f * lastDigit;
+}
+}
+
+struct ControlRateTests : juce::UnitTest
+{
+    ControlRateTests() : juce::UnitTest("Control rate errors stay within the documented table", "ControlRate") {}
+
+    void runTest() override
+    {
+        beginTest("Intervals are rounded down to 1, 8, 16 or 32");
+        const std::pair<size_t, size_t> roundings[] {{0, 1}, {1, 1}, {4, 1}, {8, 8}, {12, 8}, {16, 16}, {31, 16}, {32, 32}, {1000, 32}};
+        for(auto [requested, expected] : roundings)
+        {
+            expectEquals(static_cast<int>(CompressorKernel<float>::getSupportedControlInterval(requested)), static_cast<int>(expected),
+                         "interval " + juce::String(static_cast<int>(requested)));
+        }
+
+        beginTest("Error against audio rate");
+        const auto input = makeSignal();
+        logMessage("attack    every 8 samples         every 16 samples        every 32 samples");
+
+        for(size_t row = 0; row < std::size(attackTimesMs); ++row)
+        {
+            const auto attackMs = attackTimesMs[row];
+            const auto audioRate = compress(input, attackMs, 1);
+            auto line = juce::String(static_cast<int>(attackMs)).paddedLeft(' ', 6) + " ms";
+
+            for(size_t column = 0; column < std::size(controlIntervals); ++column)
+            {
+                const auto error = measure(input, audioRate, compress(input, attackMs, controlIntervals[column]));
+                const auto& documented = documentedErrors[row][column];
+                line << "   " << juce::String(error.output, 3) << " / " << juce::String(error.maxGainDb, 2)
+                     << " / " << juce::String(error.meanGainDb, 4);
+
+                const auto what = juce::String(static_cast<int>(attackMs)) + " ms attack every "
+                                + juce::String(static_cast<int>(controlIntervals[column])) + " samples";
+                expect(isWithin(error.output, documented.output, 0.001f), "output error at " + what);
+                expect(isWithin(error.maxGainDb, documented.maxGainDb, 0.01f), "largest gain error at " + what);
+                expect(isWithin(error.meanGainDb, documented.meanGainDb, 0.0001f), "mean gain error at " + what);
+            }
+
+            logMessage(line);
+        }
+    }
+};
+
+static ControlRateTests controlRateTests;
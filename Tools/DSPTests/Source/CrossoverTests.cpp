@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    CrossoverTests.cpp
+    Created: 17 Oct 2026 4:12:38pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/Crossover.h"
+
+/*
+ The generated crossover has to give the Linkwitz-Riley bands that juce::dsp::LinkwitzRileyFilter gives, and they have
+ to sum back to a flat magnitude
+
+ The kernels compare every table against the scalar one, which cannot catch a mistake they all share, so here the
+ scalar table's impulse responses are compared with a cascade of JUCE's filters wired as Crossover.h describes:
+ band b is the high-pass of every crossover below it, the low-pass of crossover b and the allpass of every crossover
+ above it. Both are measured at a set of frequencies across the audio band.
+
+ A channel that a block leaves out, as the processor does while the input is dual mono, has to start again from
+ silence when it comes back, rather than from whatever its lanes were filtering when it went away.
+ */
+namespace
+{
+constexpr double sampleRate = 48000.0;
+
+// Long enough for the lowest crossover's bands to ring down far below float resolution
+constexpr int impulseLength = 1 << 15;
+
+// The magnitudes are compared in dB wherever the band is above -60 dB, and as absolute gains below that
+constexpr double toleranceDb = 0.01;
+constexpr double floorDb = -60.0;
+constexpr double toleranceBelowFloor = 1.0e-4;
+
+// The magnitude of an impulse response at one frequency
+double getMagnitude(const float* impulse, double frequency)
+{
+    std::complex<double> sum;
+    const auto step = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate);
+    auto phasor = std::complex<double>(1.0);
+
+    for(int i = 0; i < impulseLength; ++i)
+    {
+        sum += static_cast<double>(impulse[i]) * phasor;
+        phasor *= step;
+    }
+
+    return std::abs(sum);
+}
+
+// Third octaves from 20 Hz to 20 kHz
+std::vector<double> getTestFrequencies()
+{
+    std::vector<double> frequencies;
+    for(auto frequency = 20.0; frequency <= 20000.0; frequency *= std::pow(2.0, 1.0 / 3.0))
+    {
+        frequencies.push_back(frequency);
+    }
+
+    return frequencies;
+}
+}
+
+struct CrossoverTests : juce::UnitTest
+{
+    CrossoverTests() : juce::UnitTest("Crossover bands match JUCE's Linkwitz-Riley filters", "Crossover") {}
+
+    void runTest() override
+    {
+        beginTest("Two crossovers at 100 Hz and 1 kHz");
+        testBands<3>({100.0f, 1000.0f});
+
+        beginTest("Two crossovers at 500 Hz and 5 kHz");
+        testBands<3>({500.0f, 5000.0f});
+
+        beginTest("Three crossovers at 80 Hz, 800 Hz and 8 kHz");
+        testBands<4>({80.0f, 800.0f, 8000.0f});
+
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa) + ": a channel left out starts again from silence");
+            testDroppedChannel(DSPKernels::getTable(isa));
+        }
+    }
+
+    // Stereo, mono, then stereo again. When it returns, the second channel has to match a crossover that only ever
+    // saw silence on it
+    void testDroppedChannel(const DSPKernels::Table& table)
+    {
+        constexpr int blockSize = 256;
+        constexpr float cutoffs[] {200.0f, 2000.0f};
+
+        Crossover<3> returning, silent;
+        for(auto* crossover : {&returning, &silent})
+        {
+            crossover->prepare({sampleRate, static_cast<juce::uint32>(blockSize), 2}, table);
+            for(size_t i = 0; i < std::size(cutoffs); ++i)
+            {
+                crossover->setCrossoverFrequency(i, cutoffs[i]);
+            }
+        }
+
+        juce::AudioBuffer<float> input(2, blockSize);
+        std::array<juce::AudioBuffer<float>, 3> returningBands, silentBands;
+        for(size_t band = 0; band < 3; ++band)
+        {
+            returningBands[band].setSize(2, blockSize);
+            silentBands[band].setSize(2, blockSize);
+        }
+
+        auto split = [](Crossover<3>& crossover, juce::AudioBuffer<float>& in, std::array<juce::AudioBuffer<float>, 3>& out, size_t numChannels)
+        {
+            Crossover<3>::BandBlocks bands;
+            for(size_t band = 0; band < 3; ++band)
+            {
+                bands[band] = juce::dsp::AudioBlock<float>(out[band]).getSubsetChannelBlock(0, numChannels);
+            }
+
+            crossover.process(juce::dsp::AudioBlock<const float>(juce::dsp::AudioBlock<float>(in).getSubsetChannelBlock(0, numChannels)), bands);
+        };
+
+        for(int block = 0; block < 3; ++block)
+        {
+            for(int i = 0; i < blockSize; ++i)
+            {
+                input.setSample(0, i, 2.0f * getRandom().nextFloat() - 1.0f);
+                input.setSample(1, i, 2.0f * getRandom().nextFloat() - 1.0f);
+            }
+
+            const auto numChannels = block == 1 ? size_t {1} : size_t {2};
+            split(returning, input, returningBands, numChannels);
+
+            // The second channel is silent until the last block
+            auto silentInput = input;
+            if(block < 2)
+            {
+                silentInput.clear(1, 0, blockSize);
+            }
+
+            split(silent, silentInput, silentBands, numChannels);
+        }
+
+        for(size_t band = 0; band < 3; ++band)
+        {
+            expect(std::memcmp(returningBands[band].getReadPointer(1), silentBands[band].getReadPointer(1), sizeof(float) * blockSize) == 0,
+                   "band " + juce::String(static_cast<int>(band)));
+        }
+    }
+
+    template<size_t NumBands>
+    void testBands(const std::array<float, NumBands - 1>& cutoffs)
+    {
+        const auto bands = renderCrossover<NumBands>(cutoffs);
+        const auto frequencies = getTestFrequencies();
+
+        juce::AudioBuffer<float> sum(1, impulseLength);
+        sum.clear();
+
+        for(size_t band = 0; band < NumBands; ++band)
+        {
+            const auto reference = renderReference<NumBands>(cutoffs, band);
+            const auto* actual = bands.getReadPointer(static_cast<int>(band));
+            sum.addFrom(0, 0, actual, impulseLength);
+
+            auto largestError = 0.0;
+            for(auto frequency : frequencies)
+            {
+                const auto expectedMagnitude = getMagnitude(reference.getReadPointer(0), frequency);
+                const auto actualMagnitude = getMagnitude(actual, frequency);
+                const auto what = "band " + juce::String(static_cast<int>(band)) + " at " + juce::String(frequency, 1) + " Hz";
+
+                if(juce::Decibels::gainToDecibels(expectedMagnitude, -200.0) > floorDb)
+                {
+                    const auto error = std::abs(juce::Decibels::gainToDecibels(actualMagnitude / expectedMagnitude, -200.0));
+                    largestError = std::max(largestError, error);
+                    expect(error < toleranceDb, what + " is " + juce::String(error, 6) + " dB off");
+                }
+                else
+                {
+                    expect(std::abs(actualMagnitude - expectedMagnitude) < toleranceBelowFloor, what);
+                }
+            }
+
+            logMessage("band " + juce::String(static_cast<int>(band)) + ": largest error " + juce::String(largestError, 6) + " dB");
+        }
+
+        auto largestDeviation = 0.0;
+        for(auto frequency : frequencies)
+        {
+            const auto deviation = std::abs(juce::Decibels::gainToDecibels(getMagnitude(sum.getReadPointer(0), frequency), -200.0));
+            largestDeviation = std::max(largestDeviation, deviation);
+            expect(deviation < toleranceDb, "the band sum at " + juce::String(frequency, 1) + " Hz is " + juce::String(deviation, 6) + " dB off flat");
+        }
+
+        logMessage("band sum: largest deviation from flat " + juce::String(largestDeviation, 6) + " dB");
+    }
+
+    // The impulse response of every band of the crossover, one band per channel
+    template<size_t NumBands>
+    juce::AudioBuffer<float> renderCrossover(const std::array<float, NumBands - 1>& cutoffs)
+    {
+        Crossover<NumBands> crossover;
+        crossover.prepare({sampleRate, static_cast<juce::uint32>(impulseLength), 1}, *DSPKernels::Scalar::getTable());
+        for(size_t i = 0; i < cutoffs.size(); ++i)
+        {
+            crossover.setCrossoverFrequency(i, cutoffs[i]);
+        }
+
+        juce::AudioBuffer<float> impulse(1, impulseLength);
+        impulse.clear();
+        impulse.setSample(0, 0, 1.0f);
+
+        juce::AudioBuffer<float> output(static_cast<int>(NumBands), impulseLength);
+        typename Crossover<NumBands>::BandBlocks bands;
+        for(size_t band = 0; band < NumBands; ++band)
+        {
+            bands[band] = juce::dsp::AudioBlock<float>(output).getSubsetChannelBlock(band, 1);
+        }
+
+        crossover.process(juce::dsp::AudioBlock<const float>(juce::dsp::AudioBlock<float>(impulse)), bands);
+        return output;
+    }
+
+    // The impulse response of one band through JUCE's filters
+    template<size_t NumBands>
+    juce::AudioBuffer<float> renderReference(const std::array<float, NumBands - 1>& cutoffs, size_t band)
+    {
+        using Filter = juce::dsp::LinkwitzRileyFilter<float>;
+        std::array<Filter, NumBands - 1> filters;
+
+        for(size_t crossover = 0; crossover < filters.size(); ++crossover)
+        {
+            auto& filter = filters[crossover];
+            filter.setType(crossover < band ? Filter::Type::highpass
+                                            : crossover == band ? Filter::Type::lowpass : Filter::Type::allpass);
+            filter.prepare({sampleRate, static_cast<juce::uint32>(impulseLength), 1});
+            filter.setCutoffFrequency(cutoffs[crossover]);
+        }
+
+        juce::AudioBuffer<float> output(1, impulseLength);
+        for(int i = 0; i < impulseLength; ++i)
+        {
+            auto sample = i == 0 ? 1.0f : 0.0f;
+            for(auto& filter : filters)
+            {
+                sample = filter.processSample(0, sample);
+            }
+
+            output.setSample(0, i, sample);
+        }
+
+        return output;
+    }
+};
+
+static CrossoverTests crossoverTests;
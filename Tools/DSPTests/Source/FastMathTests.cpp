@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    FastMathTests.cpp
+    Created: 17 Oct 2026 10:04:17am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/FastMath.h"
+
+/*
+ The polynomial log2/exp2 and dB conversions have to stay within the error bounds documented in FastMath.h
+
+ Each function is swept over the float bit patterns of its documented ranges, every one of them on [0.5, 2) where
+ log2 matters most and a fixed stride elsewhere, and compared against the double precision std functions. The
+ largest error found is logged next to its bound.
+ */
+namespace
+{
+float fromBits(uint32_t bits)
+{
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+uint32_t toBits(float x)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+// Calls f for every stride-th float from start up to and including end. Both ends have the same sign
+template<typename Function>
+void forEachFloat(float start, float end, uint32_t stride, Function f)
+{
+    const auto last = toBits(end);
+    for(auto bits = toBits(start); bits <= last; bits += stride)
+    {
+        f(fromBits(bits));
+    }
+
+    f(end);
+}
+
+// The worst error found in a sweep, and where
+struct MaxError
+{
+    void add(double error, double at)
+    {
+        if(error > value)
+        {
+            value = error;
+            argument = at;
+        }
+    }
+
+    double value {0}, argument {0};
+};
+}
+
+struct FastMathTests : juce::UnitTest
+{
+    FastMathTests() : juce::UnitTest("Fast math stays within its documented error", "FastMath") {}
+
+    void runTest() override
+    {
+        beginTest("Unity is exact");
+        expect(FastMath::log2(1.0f) == 0.0f, "log2(1)");
+        expect(FastMath::exp2(0.0f) == 1.0f, "exp2(0)");
+        expect(FastMath::gainToDecibels(1.0f) == 0.0f, "gainToDecibels(1)");
+        expect(FastMath::decibelsToGain(0.0f) == 1.0f, "decibelsToGain(0)");
+
+        beginTest("log2");
+        testLog2(0.5f, std::nextafter(2.0f, 0.0f), 1, 8.0e-7);
+        testLog2(1.0e-6f, 16.0f, 7, 2.0e-6);
+        testLog2(std::numeric_limits<float>::min(), std::numeric_limits<float>::max(), 101, 5.0e-6);
+
+        beginTest("exp2");
+        testExp2();
+
+        beginTest("gainToDecibels");
+        testGainToDecibels(1.0e-6f, 16.0f, 7, 2.0e-5);
+        testGainToDecibels(std::numeric_limits<float>::min(), std::numeric_limits<float>::max(), 101, 7.0e-5);
+
+        beginTest("decibelsToGain");
+        testDecibelsToGain();
+
+        beginTest("Floors and clamps follow juce::Decibels");
+        for(auto gain : {0.0f, -1.0f, 1.0e-7f})
+        {
+            expect(FastMath::gainToDecibels(gain) == juce::Decibels::gainToDecibels(gain), "gainToDecibels(" + juce::String(gain) + ")");
+        }
+
+        for(auto decibels : {-100.0f, -120.0f})
+        {
+            expect(FastMath::decibelsToGain(decibels) == juce::Decibels::decibelsToGain(decibels), "decibelsToGain(" + juce::String(decibels) + ")");
+        }
+
+        expect(FastMath::exp2(200.0f) == FastMath::exp2(126.0f), "exp2 is clamped above 126");
+        expect(FastMath::exp2(-200.0f) == FastMath::exp2(-126.0f), "exp2 is clamped below -126");
+    }
+
+    void testLog2(float start, float end, uint32_t stride, double bound)
+    {
+        MaxError error;
+        forEachFloat(start, end, stride, [&error](float x)
+        {
+            error.add(std::abs(FastMath::log2(x) - std::log2(static_cast<double>(x))), x);
+        });
+
+        check("log2", start, end, error, bound);
+    }
+
+    void testExp2()
+    {
+        // The sweep walks the bit patterns of one sign, so every magnitude is tried with both
+        MaxError error;
+        forEachFloat(0.0f, 126.0f, 97, [&error](float magnitude)
+        {
+            for(auto x : {-magnitude, magnitude})
+            {
+                const auto exact = std::exp2(static_cast<double>(x));
+                error.add(std::abs(FastMath::exp2(x) - exact) / exact, x);
+            }
+        });
+
+        check("exp2 relative", -126.0f, 126.0f, error, 1.0e-7);
+    }
+
+    void testGainToDecibels(float start, float end, uint32_t stride, double bound)
+    {
+        MaxError error;
+        forEachFloat(start, end, stride, [&error](float gain)
+        {
+            // Below the -100 dB floor the result is the floor, as with juce::Decibels
+            const auto exact = std::max(-100.0, 20.0 * std::log10(static_cast<double>(gain)));
+            error.add(std::abs(FastMath::gainToDecibels(gain) - exact), gain);
+        });
+
+        check("gainToDecibels", start, end, error, bound);
+    }
+
+    void testDecibelsToGain()
+    {
+        // -100 dB itself is the floor, where the gain is 0
+        MaxError error;
+        for(int i = 1; i <= 1400000; ++i)
+        {
+            const auto decibels = -100.0f + static_cast<float>(i) * 1.0e-4f;
+            const auto exact = std::pow(10.0, static_cast<double>(decibels) / 20.0);
+            error.add(std::abs(FastMath::decibelsToGain(decibels) - exact) / exact, decibels);
+        }
+
+        check("decibelsToGain relative", -100.0f, 40.0f, error, 8.0e-7);
+    }
+
+    void check(const juce::String& what, float start, float end, const MaxError& error, double bound)
+    {
+        const auto message = what + " error on [" + juce::String(start) + ", " + juce::String(end) + "]: "
+                           + juce::String(error.value, 10) + " at " + juce::String(error.argument)
+                           + ", bound " + juce::String(bound, 10);
+        logMessage(message);
+        expect(error.value < bound, message);
+    }
+};
+
+static FastMathTests fastMathTests;
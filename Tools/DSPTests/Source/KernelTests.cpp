@@ -0,0 +1,258 @@
+/*
+  ==============================================================================
+
+    KernelTests.cpp
+    Created: 17 Oct 2026 9:12:31am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/Crossover.h"
+#include "../../../Source/DSP/CompressorKernel.h"
+
+/*
+ Every instruction set table has to give the same bits as the scalar reference (see DSPKernelsImpl.h)
+
+ Each table the CPU supports runs side by side with the scalar one on the same random input: the crossover, the
+ compressor with every detector and control interval, bypassed blocks that are only metered, and the band sum. Every
+ output, gain reduction and meter reading is compared bit for bit. Each test runs once on the buffers as allocated
+ and once with every pointer moved one float past them, since a host's buffers need not be aligned for any register.
+ */
+namespace
+{
+using namespace DSPKernels;
+
+constexpr size_t maxBlockSize = 512;
+constexpr int numBlocks = 40;
+
+// Room for the misaligned runs, which start their buffers this many floats in
+constexpr size_t maxOffset = 1;
+constexpr auto bufferSize = static_cast<int>(maxBlockSize + maxOffset);
+
+bool isBitIdentical(const float* a, const float* b, size_t numValues)
+{
+    return std::memcmp(a, b, numValues * sizeof(float)) == 0;
+}
+
+// Noise at a random level between -80 and +6 dBFS, so the compressors see blocks below, inside and above the knee
+void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+{
+    const auto level = juce::Decibels::decibelsToGain(random.nextFloat() * 86.0f - 80.0f);
+    for(int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        for(int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            buffer.setSample(channel, i, level * (2.0f * random.nextFloat() - 1.0f));
+        }
+    }
+}
+
+size_t nextBlockSize(juce::Random& random)
+{
+    return static_cast<size_t>(random.nextInt({1, static_cast<int>(maxBlockSize) + 1}));
+}
+}
+
+struct KernelTests : juce::UnitTest
+{
+    KernelTests() : juce::UnitTest("DSP kernels match the scalar table", "Kernels") {}
+
+    void runTest() override
+    {
+        for(auto isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512})
+        {
+            if(! isSupported(isa))
+            {
+                logMessage(getIsaName(isa) + " is not supported on this CPU, skipped");
+                continue;
+            }
+
+            const auto& table = getTable(isa);
+
+            for(size_t offset = 0; offset <= maxOffset; ++offset)
+            {
+                const auto name = getIsaName(isa) + (offset == 0 ? juce::String() : " misaligned");
+
+                beginTest(name + " crossover");
+                testCrossover(table, offset);
+
+                for(auto detector : {Detector::Peak, Detector::RMS, Detector::TruePeak})
+                {
+                    for(size_t controlInterval : {1, 8, 16, 32})
+                    {
+                        beginTest(name + " compressor, detector " + juce::String(static_cast<int>(detector))
+                                  + ", control interval " + juce::String(static_cast<int>(controlInterval)));
+                        testCompressor(table, detector, controlInterval, offset);
+                    }
+                }
+
+                beginTest(name + " band sum");
+                testSumBands(table, offset);
+            }
+        }
+    }
+
+    void testCrossover(const Table& table, size_t offset)
+    {
+        constexpr size_t numBands = 3;
+        const juce::dsp::ProcessSpec spec {48000.0, static_cast<juce::uint32>(maxBlockSize), 2};
+
+        Crossover<numBands> reference, crossover;
+        reference.prepare(spec, *Scalar::getTable());
+        crossover.prepare(spec, table);
+
+        for(size_t i = 0; i < numBands - 1; ++i)
+        {
+            const auto frequency = 100.0f * std::pow(100.0f, (static_cast<float>(i) + getRandom().nextFloat()) / (numBands - 1));
+            reference.setCrossoverFrequency(i, frequency);
+            crossover.setCrossoverFrequency(i, frequency);
+        }
+
+        juce::AudioBuffer<float> input(2, bufferSize);
+        std::array<float, maxBlockSize + maxOffset> inputGains {};
+        std::array<juce::AudioBuffer<float>, numBands> expected, actual;
+        for(size_t band = 0; band < numBands; ++band)
+        {
+            expected[band].setSize(2, bufferSize);
+            actual[band].setSize(2, bufferSize);
+        }
+
+        for(int block = 0; block < numBlocks; ++block)
+        {
+            const auto numSamples = nextBlockSize(getRandom());
+            fillWithNoise(input, getRandom());
+
+            // Every other block ramps the input gain, as the processor does while the gain parameter moves
+            const auto rampsGain = getRandom().nextBool();
+            for(size_t i = 0; i < numSamples; ++i)
+            {
+                inputGains[offset + i] = 0.5f + getRandom().nextFloat();
+            }
+
+            std::array<juce::dsp::AudioBlock<float>, numBands> expectedBands, actualBands;
+            for(size_t band = 0; band < numBands; ++band)
+            {
+                expectedBands[band] = juce::dsp::AudioBlock<float>(expected[band]).getSubBlock(offset, numSamples);
+                actualBands[band] = juce::dsp::AudioBlock<float>(actual[band]).getSubBlock(offset, numSamples);
+            }
+
+            const auto inputBlock = juce::dsp::AudioBlock<const float>(juce::dsp::AudioBlock<float>(input).getSubBlock(offset, numSamples));
+            const auto* rampedGains = rampsGain ? inputGains.data() + offset : nullptr;
+            reference.process(inputBlock, expectedBands, rampedGains, 0.8f);
+            crossover.process(inputBlock, actualBands, rampedGains, 0.8f);
+
+            for(size_t band = 0; band < numBands; ++band)
+            {
+                for(size_t channel = 0; channel < 2; ++channel)
+                {
+                    expect(isBitIdentical(expectedBands[band].getChannelPointer(channel), actualBands[band].getChannelPointer(channel), numSamples),
+                           "band " + juce::String(static_cast<int>(band)) + " channel " + juce::String(static_cast<int>(channel))
+                           + " of block " + juce::String(block));
+                }
+            }
+        }
+    }
+
+    void testCompressor(const Table& table, Detector detector, size_t controlInterval, size_t offset)
+    {
+        const juce::dsp::ProcessSpec spec {48000.0, static_cast<juce::uint32>(maxBlockSize), 2};
+
+        CompressorKernel<float> reference, compressor;
+        for(auto* kernel : {&reference, &compressor})
+        {
+            kernel->prepare(spec, kernel == &reference ? *Scalar::getTable() : table);
+        }
+
+        juce::AudioBuffer<float> expected(2, bufferSize), actual(2, bufferSize);
+
+        for(int block = 0; block < numBlocks; ++block)
+        {
+            // New settings now and then, the same for both
+            if(block % 8 == 0)
+            {
+                const auto thresholdDb = -60.0f * getRandom().nextFloat();
+                const auto ratio = 1.0f + 19.0f * getRandom().nextFloat();
+                const auto attackMs = static_cast<float>(getRandom().nextInt({5, 101}));
+                const auto releaseMs = static_cast<float>(getRandom().nextInt({5, 501}));
+                const auto kneeDb = getRandom().nextBool() ? 0.0f : 12.0f * getRandom().nextFloat();
+
+                for(auto* kernel : {&reference, &compressor})
+                {
+                    kernel->setDetector(detector);
+                    kernel->setControlInterval(controlInterval);
+                    kernel->setThreshold(thresholdDb);
+                    kernel->setRatio(ratio);
+                    kernel->setAttack(attackMs);
+                    kernel->setRelease(releaseMs);
+                    kernel->setKnee(kneeDb);
+                }
+            }
+
+            const auto numSamples = nextBlockSize(getRandom());
+            fillWithNoise(expected, getRandom());
+            actual.makeCopyOf(expected);
+
+            auto expectedBlock = juce::dsp::AudioBlock<float>(expected).getSubBlock(offset, numSamples);
+            auto actualBlock = juce::dsp::AudioBlock<float>(actual).getSubBlock(offset, numSamples);
+            juce::dsp::ProcessContextReplacing<float> expectedContext(expectedBlock), actualContext(actualBlock);
+
+            // A bypassed block is only metered, by Table::measure
+            expectedContext.isBypassed = actualContext.isBypassed = block % 7 == 6;
+
+            reference.clearMeters();
+            compressor.clearMeters();
+            reference.process(expectedContext);
+            compressor.process(actualContext);
+
+            const auto what = " of block " + juce::String(block);
+            for(size_t channel = 0; channel < 2; ++channel)
+            {
+                expect(isBitIdentical(expectedBlock.getChannelPointer(channel), actualBlock.getChannelPointer(channel), numSamples),
+                       "output channel " + juce::String(static_cast<int>(channel)) + what);
+            }
+
+            const float expectedMeters[] {reference.getInputRMS(), reference.getInputPeak(), reference.getOutputRMS(),
+                                          reference.getOutputPeak(), reference.getDeepestGainReductionDb()};
+            const float actualMeters[] {compressor.getInputRMS(), compressor.getInputPeak(), compressor.getOutputRMS(),
+                                        compressor.getOutputPeak(), compressor.getDeepestGainReductionDb()};
+            expect(isBitIdentical(expectedMeters, actualMeters, std::size(expectedMeters)), "meters" + what);
+        }
+    }
+
+    void testSumBands(const Table& table, size_t offset)
+    {
+        constexpr size_t maxBands = 3;
+
+        juce::AudioBuffer<float> bands(static_cast<int>(maxBands), bufferSize);
+        juce::AudioBuffer<float> output(2, bufferSize);
+        std::array<float, maxBlockSize + maxOffset> gains {};
+
+        for(int block = 0; block < numBlocks; ++block)
+        {
+            const auto numSamples = nextBlockSize(getRandom());
+            const auto numBands = static_cast<size_t>(getRandom().nextInt(static_cast<int>(maxBands) + 1));
+            fillWithNoise(bands, getRandom());
+            for(auto& gain : gains)
+            {
+                gain = 2.0f * getRandom().nextFloat();
+            }
+
+            std::array<const float*, maxBands> channels {};
+            for(size_t band = 0; band < numBands; ++band)
+            {
+                channels[band] = bands.getReadPointer(static_cast<int>(band)) + offset;
+            }
+
+            const auto* rampedGains = getRandom().nextBool() ? gains.data() + offset : nullptr;
+            Scalar::getTable()->sumBands({channels.data(), numBands, numSamples, rampedGains, 0.7f, output.getWritePointer(0) + offset});
+            table.sumBands({channels.data(), numBands, numSamples, rampedGains, 0.7f, output.getWritePointer(1) + offset});
+
+            expect(isBitIdentical(output.getReadPointer(0) + offset, output.getReadPointer(1) + offset, numSamples),
+                   juce::String(static_cast<int>(numBands)) + " bands in block " + juce::String(block));
+        }
+    }
+};
+
+static KernelTests kernelTests;
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 9:12:31am
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include <iostream>
+
+/*
+ Runs the DSP unit tests headlessly
+
+ Build DSPTests.jucer (Projucer --resave, then make in Builds/LinuxMakefile, or the Xcode project) and run the
+ executable. Each test is a juce::UnitTest in its own file next to this one, registered by a static instance.
+
+ Options:
+     --category NAME    only run the tests of one category: Kernels, Crossover, FastMath, ControlRate
+                        or Processor
+     --seed N           random seed, 1 by default
+
+ Exits with 1 if any test failed.
+ */
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::StringArray arguments(argv + 1, argc - 1);
+
+    auto getOption = [&arguments](const juce::String& name)
+    {
+        const auto index = arguments.indexOf(name);
+        return index >= 0 && index + 1 < arguments.size() ? arguments[index + 1] : juce::String();
+    };
+
+    const auto category = getOption("--category");
+    const auto seedOption = getOption("--seed");
+    const auto seed = seedOption.isEmpty() ? juce::int64 {1} : seedOption.getLargeIntValue();
+
+    // The processor tests create the plugin, whose parameter tree needs the message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if(category.isEmpty())
+        runner.runAllTests(seed);
+    else
+        runner.runTestsInCategory(category, seed);
+
+    int numTests = 0, numFailures = 0;
+    for(int i = 0; i < runner.getNumResults(); ++i)
+    {
+        const auto* result = runner.getResult(i);
+        numTests += result->passes + result->failures;
+        numFailures += result->failures;
+    }
+
+    std::cout << numTests << " checks, " << numFailures << " failed" << std::endl;
+    return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1058 @@
+/*
+  ==============================================================================
+
+    ProcessorTests.cpp
+    Created: 17 Oct 2026 1:47:09pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/DSP/Params.h"
+
+/*
+ Processing a block in tiles has to give the same bits as running each stage over the whole block
+
+ The same scripted session is rendered untiled and at several tile sizes, for every kernel table the CPU supports,
+ at audio and control rate and at block sizes that are and are not multiples of a tile. The script ramps both gains,
+ solos a band and releases it, bypasses every band and brings them back through the crossfade, changes a threshold
+ and a crossover, and moves the input in and out of dual mono.
+
+ Applying the gains inside the split and the band sum has to give the same bits as separate gain passes. A session
+ that moves both gains is compared with the same session run at 0 dB, with the same ramps applied to its input and
+ output by hand. The host's channels start one float into their allocation, so no kernel can rely on their alignment.
+
+ Skipping the bands that are not heard must not change the ones that are. Sessions with bands soloed or muted are
+ compared with the processor's signal path put together from its parts, which compresses every band and only then
+ drops the ones not heard. When a solo is released, the bands that were skipped have to settle on their level again
+ rather than pick up from where they were before the solo.
+
+ While every band is bypassed only the crossover's allpass runs, and handing over to it and back has to sound the
+ same as the band sum, whatever happens to Bypass Phase Match in between.
+
+ Once the input has stayed below the silence floor for longer than the tail the output is silence, and when the
+ input comes back it has to sound as if the processor had never stopped. In the same way, processing dual mono input
+ once has to sound like processing every channel, in and out of dual mono.
+
+ Host blocks larger than the prepared block size are processed in chunks, which has to give the same bits as the
+ host sending those chunks as blocks of their own.
+ */
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int numBlocks = 200;
+constexpr int numChannels = 2;
+
+struct Scenario
+{
+    DSPKernels::Isa isa;
+    int blockSize;
+    int gainControlInterval;
+};
+
+void setParameter(SimpleMBCompAudioProcessor& processor, const juce::String& paramID, float value)
+{
+    auto* parameter = processor.apvts.getParameter(paramID);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+void setBandParameter(SimpleMBCompAudioProcessor& processor, Params::BandParam param, size_t band, float value)
+{
+    setParameter(processor, Params::getBandParamID(param, band, SimpleMBCompAudioProcessor::NumBands), value);
+}
+
+void setGains(SimpleMBCompAudioProcessor& processor, float inputDb, float outputDb)
+{
+    const auto& params = Params::GetParams();
+    setParameter(processor, params.at(Params::Names::Gain_In), inputDb);
+    setParameter(processor, params.at(Params::Names::Gain_Out), outputDb);
+}
+
+void setAllBypassed(SimpleMBCompAudioProcessor& processor, bool bypassed)
+{
+    for(size_t band = 0; band < SimpleMBCompAudioProcessor::NumBands; ++band)
+    {
+        setBandParameter(processor, Params::BandParam::Bypassed, band, bypassed ? 1.0f : 0.0f);
+    }
+}
+
+// Applies whatever the script does before the given block
+void runScript(SimpleMBCompAudioProcessor& processor, int block)
+{
+    using Params::BandParam;
+
+    switch(block)
+    {
+        case 30: setGains(processor, -6.0f, 4.5f); break;
+        case 45: setGains(processor, 3.0f, -2.0f); break;
+        case 70: setBandParameter(processor, BandParam::Solo, 1, 1.0f); break;
+        case 100: setBandParameter(processor, BandParam::Solo, 1, 0.0f); break;
+        case 110: setAllBypassed(processor, true); break;
+        case 125:
+            setBandParameter(processor, BandParam::Threshold, 1, -40.0f);
+            setParameter(processor, Params::getCrossoverParamID(0, SimpleMBCompAudioProcessor::NumBands), 200.0f);
+            break;
+        case 140: setAllBypassed(processor, false); break;
+        default: break;
+    }
+}
+
+// A 220 Hz sine with noise. The channels are the same from block 60 to 149 and differ otherwise
+void fillInput(juce::AudioBuffer<float>& buffer, int block, double& phase, std::mt19937& noise)
+{
+    const auto isDualMono = block >= 60 && block < 150;
+
+    for(int i = 0; i < buffer.getNumSamples(); ++i)
+    {
+        phase += juce::MathConstants<double>::twoPi * 220.0 / sampleRate;
+        const auto white = 2.0f * static_cast<float>(noise() >> 8) / 16777216.0f - 1.0f;
+        const auto sample = 0.5f * static_cast<float>(std::sin(phase)) + 0.2f * white;
+
+        buffer.setSample(0, i, sample);
+        buffer.setSample(1, i, isDualMono ? sample : 0.7f * sample);
+    }
+}
+
+// Every band compresses the input, each with its own detector
+void setBands(SimpleMBCompAudioProcessor& processor)
+{
+    for(size_t band = 0; band < SimpleMBCompAudioProcessor::NumBands; ++band)
+    {
+        setBandParameter(processor, Params::BandParam::Threshold, band, -30.0f - 6.0f * static_cast<float>(band));
+        setBandParameter(processor, Params::BandParam::Knee, band, 6.0f);
+        setBandParameter(processor, Params::BandParam::Detector, band, static_cast<float>(band));
+    }
+}
+
+juce::AudioBuffer<float> render(const Scenario& scenario, int tileSize)
+{
+    SimpleMBCompAudioProcessor processor;
+    processor.setForcedKernelIsa(scenario.isa);
+    processor.setTileSize(tileSize);
+    processor.setGainControlInterval(scenario.gainControlInterval);
+
+    // Blocks that go to the worker pool are never tiled
+    processor.setParallelBandThreshold(0);
+    setBands(processor);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, scenario.blockSize);
+    processor.prepareToPlay(sampleRate, scenario.blockSize);
+
+    juce::AudioBuffer<float> output(numChannels, numBlocks * scenario.blockSize);
+    juce::AudioBuffer<float> buffer(numChannels, scenario.blockSize);
+    juce::MidiBuffer midi;
+    std::mt19937 noise(1);
+    double phase = 0;
+
+    for(int block = 0; block < numBlocks; ++block)
+    {
+        runScript(processor, block);
+        fillInput(buffer, block, phase, noise);
+        processor.processBlock(buffer, midi);
+
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            output.copyFrom(channel, block * scenario.blockSize, buffer, channel, 0, scenario.blockSize);
+        }
+    }
+
+    processor.releaseResources();
+    return output;
+}
+
+// The gain ramp of the processor
+constexpr double gainRampSeconds = 0.05;
+
+// The gains of the gain session before the given block, if they change there. The processor ramps up from silence
+// over its first 50 ms, so they only move once that is over at every block size of the test
+std::optional<std::pair<float, float>> getScriptedGains(int block)
+{
+    switch(block)
+    {
+        case 70: return std::make_pair(-6.0f, 4.5f);
+        case 85: return std::make_pair(3.0f, -2.0f);
+        case 160: return std::make_pair(0.0f, 0.0f);
+        default: return std::nullopt;
+    }
+}
+
+// Renders the gain session, with the gains either set on the processor or applied around it
+juce::AudioBuffer<float> renderGains(DSPKernels::Isa isa, int blockSize, bool gainsInProcessor)
+{
+    SimpleMBCompAudioProcessor processor;
+    processor.setForcedKernelIsa(isa);
+    processor.setParallelBandThreshold(0);
+    setBands(processor);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::SmoothedValue<float> inputGain, outputGain;
+    for(auto* gain : {&inputGain, &outputGain})
+    {
+        gain->reset(sampleRate, gainRampSeconds);
+        gain->setCurrentAndTargetValue(1.0f);
+    }
+
+    juce::AudioBuffer<float> allocation(numChannels, blockSize + 1);
+    float* channels[] {allocation.getWritePointer(0) + 1, allocation.getWritePointer(1) + 1};
+    juce::AudioBuffer<float> buffer(channels, numChannels, blockSize);
+
+    juce::AudioBuffer<float> output(numChannels, numBlocks * blockSize);
+    juce::MidiBuffer midi;
+    std::mt19937 noise(1);
+    double phase = 0;
+
+    auto applyGain = [&buffer](juce::SmoothedValue<float>& gain)
+    {
+        for(int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto value = gain.getNextValue();
+            for(int channel = 0; channel < numChannels; ++channel)
+            {
+                buffer.setSample(channel, i, buffer.getSample(channel, i) * value);
+            }
+        }
+    };
+
+    for(int block = 0; block < numBlocks; ++block)
+    {
+        if(const auto gains = getScriptedGains(block))
+        {
+            if(gainsInProcessor)
+            {
+                setGains(processor, gains->first, gains->second);
+            } else
+            {
+                inputGain.setTargetValue(juce::Decibels::decibelsToGain(gains->first));
+                outputGain.setTargetValue(juce::Decibels::decibelsToGain(gains->second));
+            }
+        }
+
+        // The band changes of the tile session fall in between
+        if(block == 70 || block == 100 || block == 125)
+        {
+            runScript(processor, block);
+        }
+
+        fillInput(buffer, block, phase, noise);
+        if(! gainsInProcessor)
+        {
+            applyGain(inputGain);
+        }
+
+        processor.processBlock(buffer, midi);
+        if(! gainsInProcessor)
+        {
+            applyGain(outputGain);
+        }
+
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            output.copyFrom(channel, block * blockSize, buffer, channel, 0, blockSize);
+        }
+    }
+
+    processor.releaseResources();
+    return output;
+}
+}
+
+struct TileTests : juce::UnitTest
+{
+    TileTests() : juce::UnitTest("Tiled processing matches the untiled order", "Processor") {}
+
+    void runTest() override
+    {
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa));
+
+            for(auto blockSize : {37, 512, 1000})
+            {
+                for(auto gainControlInterval : {1, 8})
+                {
+                    const Scenario scenario {isa, blockSize, gainControlInterval};
+                    const auto expected = render(scenario, 0);
+
+                    for(auto tileSize : {64, 100, SimpleMBCompAudioProcessor::defaultTileSize})
+                    {
+                        const auto actual = render(scenario, tileSize);
+                        const auto what = "tile " + juce::String(tileSize) + ", block " + juce::String(blockSize)
+                                        + ", control interval " + juce::String(gainControlInterval);
+
+                        for(int channel = 0; channel < numChannels; ++channel)
+                        {
+                            expect(std::memcmp(expected.getReadPointer(channel), actual.getReadPointer(channel),
+                                               static_cast<size_t>(expected.getNumSamples()) * sizeof(float)) == 0,
+                                   what + ", channel " + juce::String(channel));
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+static TileTests tileTests;
+
+struct GainTests : juce::UnitTest
+{
+    GainTests() : juce::UnitTest("Fused gains match separate gain passes", "Processor") {}
+
+    void runTest() override
+    {
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa));
+
+            for(auto blockSize : {37, 512, 1000})
+            {
+                const auto expected = renderGains(isa, blockSize, false);
+                const auto actual = renderGains(isa, blockSize, true);
+
+                for(int channel = 0; channel < numChannels; ++channel)
+                {
+                    expect(std::memcmp(expected.getReadPointer(channel), actual.getReadPointer(channel),
+                                       static_cast<size_t>(expected.getNumSamples()) * sizeof(float)) == 0,
+                           "block " + juce::String(blockSize) + ", channel " + juce::String(channel));
+                }
+            }
+        }
+    }
+};
+
+static GainTests gainTests;
+
+namespace
+{
+constexpr auto numBands = SimpleMBCompAudioProcessor::NumBands;
+using HeardBands = std::array<bool, numBands>;
+
+/*
+ The processor's signal path put together from its parts, with none of its shortcuts: every band is split and
+ compressed on every block, and only then are the bands that are heard summed. The bands read the processor's own
+ parameters, and the gains ramp up from silence as the processor's do when it starts
+ */
+struct ReferencePath
+{
+    ReferencePath(SimpleMBCompAudioProcessor& processor, DSPKernels::Isa isa, int blockSize)
+    {
+        const juce::dsp::ProcessSpec spec {sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels)};
+        const auto& table = DSPKernels::getTable(isa);
+
+        crossover.prepare(spec, table);
+        for(size_t i = 0; i < Crossover<numBands>::NumCrossovers; ++i)
+        {
+            auto* frequency = dynamic_cast<juce::AudioParameterFloat*>(processor.apvts.getParameter(Params::getCrossoverParamID(i, numBands)));
+            crossover.setCrossoverFrequency(i, frequency->get());
+        }
+
+        for(size_t i = 0; i < numBands; ++i)
+        {
+            const auto& source = processor.compressors[i];
+            auto& band = bands[i];
+            band.attack = source.attack;
+            band.release = source.release;
+            band.threshold = source.threshold;
+            band.ratio = source.ratio;
+            band.knee = source.knee;
+            band.detector = source.detector;
+            band.bypassed = source.bypassed;
+            band.mute = source.mute;
+            band.solo = source.solo;
+
+            band.prepare(spec, table);
+            for(size_t param = 0; param < Params::NumBandParams; ++param)
+            {
+                band.updateCompressorSetting(static_cast<Params::BandParam>(param));
+            }
+
+            bandBuffers[i].setSize(numChannels, blockSize);
+        }
+
+        for(auto* gain : {&inputGain, &outputGain})
+        {
+            gain->reset(sampleRate, gainRampSeconds);
+            gain->setTargetValue(1.0f);
+        }
+
+        input.setSize(numChannels, blockSize);
+    }
+
+    // Processes the buffer in place, with the bands that heard says
+    void process(juce::AudioBuffer<float>& buffer, const HeardBands& heard)
+    {
+        const auto numSamples = buffer.getNumSamples();
+        for(int i = 0; i < numSamples; ++i)
+        {
+            const auto gain = inputGain.getNextValue();
+            for(int channel = 0; channel < numChannels; ++channel)
+            {
+                input.setSample(channel, i, buffer.getSample(channel, i) * gain);
+            }
+        }
+
+        Crossover<numBands>::BandBlocks blocks;
+        for(size_t band = 0; band < numBands; ++band)
+        {
+            blocks[band] = juce::dsp::AudioBlock<float>(bandBuffers[band]).getSubBlock(0, static_cast<size_t>(numSamples));
+        }
+
+        crossover.process(juce::dsp::AudioBlock<const float>(juce::dsp::AudioBlock<float>(input).getSubBlock(0, static_cast<size_t>(numSamples))), blocks);
+
+        for(size_t band = 0; band < numBands; ++band)
+        {
+            bands[band].processTile(blocks[band], true, true);
+        }
+
+        // The same order of additions as the band sum kernel
+        for(int i = 0; i < numSamples; ++i)
+        {
+            const auto gain = outputGain.getNextValue();
+            for(int channel = 0; channel < numChannels; ++channel)
+            {
+                auto sum = 0.0f;
+                for(size_t band = 0; band < numBands; ++band)
+                {
+                    if(heard[band])
+                        sum += bandBuffers[band].getSample(channel, i);
+                }
+
+                buffer.setSample(channel, i, sum * gain);
+            }
+        }
+    }
+
+    Crossover<numBands> crossover;
+    std::array<CompressorBand, numBands> bands;
+    std::array<juce::AudioBuffer<float>, numBands> bandBuffers;
+    juce::AudioBuffer<float> input;
+    juce::SmoothedValue<float> inputGain, outputGain;
+};
+
+// A tone in each band, at 100 Hz, 1 kHz and 6 kHz, over noise that differs between the channels. The low tone is at
+// lowToneDb, the others at -12 dBFS
+void fillTones(juce::AudioBuffer<float>& buffer, int64_t& position, std::mt19937& noise, float lowToneDb)
+{
+    const auto lowLevel = juce::Decibels::decibelsToGain(lowToneDb);
+    const auto level = juce::Decibels::decibelsToGain(-12.0f);
+
+    for(int i = 0; i < buffer.getNumSamples(); ++i, ++position)
+    {
+        auto tone = [time = static_cast<double>(position) / sampleRate](double frequency)
+        {
+            return static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * time));
+        };
+
+        const auto tones = lowLevel * tone(100.0) + level * (tone(1000.0) + tone(6000.0));
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto white = 2.0f * static_cast<float>(noise() >> 8) / 16777216.0f - 1.0f;
+            buffer.setSample(channel, i, tones + 0.01f * white);
+        }
+    }
+}
+
+// The level of one block of a render in dB
+float getBlockLevelDb(const juce::AudioBuffer<float>& render, int block, int blockSize)
+{
+    auto sumOfSquares = 0.0;
+    for(int channel = 0; channel < numChannels; ++channel)
+    {
+        for(int i = block * blockSize; i < (block + 1) * blockSize; ++i)
+        {
+            sumOfSquares += static_cast<double>(render.getSample(channel, i)) * render.getSample(channel, i);
+        }
+    }
+
+    return static_cast<float>(10.0 * std::log10(sumOfSquares / (numChannels * blockSize)));
+}
+
+struct HeardRender
+{
+    juce::AudioBuffer<float> processor, reference;
+};
+
+// Renders the same session through the processor and through the reference path. heardAt gives the bands heard
+// before each block, which the processor is told through solo and mute; lowToneDbAt gives the level of the low tone
+template<typename HeardAt, typename LowToneDbAt>
+HeardRender renderHeard(DSPKernels::Isa isa, int blockSize, HeardAt heardAt, LowToneDbAt lowToneDbAt)
+{
+    SimpleMBCompAudioProcessor processor;
+    processor.setForcedKernelIsa(isa);
+    processor.setParallelBandThreshold(0);
+    setBands(processor);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    ReferencePath reference(processor, isa, blockSize);
+
+    HeardRender render;
+    render.processor.setSize(numChannels, numBlocks * blockSize);
+    render.reference.setSize(numChannels, numBlocks * blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize), referenceBuffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    std::mt19937 noise(1);
+    int64_t position = 0;
+    HeardBands lastHeard {};
+
+    for(int block = 0; block < numBlocks; ++block)
+    {
+        // A single band left out is muted, more than one are left out by soloing the rest
+        const HeardBands heard = heardAt(block);
+        const auto numHeard = static_cast<size_t>(std::count(heard.begin(), heard.end(), true));
+        if(block == 0 || heard != lastHeard)
+        {
+            for(size_t band = 0; band < numBands; ++band)
+            {
+                setBandParameter(processor, Params::BandParam::Mute, band, numHeard == numBands - 1 && ! heard[band] ? 1.0f : 0.0f);
+                setBandParameter(processor, Params::BandParam::Solo, band, numHeard < numBands - 1 && heard[band] ? 1.0f : 0.0f);
+            }
+
+            lastHeard = heard;
+        }
+
+        fillTones(buffer, position, noise, lowToneDbAt(block));
+        referenceBuffer.makeCopyOf(buffer);
+
+        processor.processBlock(buffer, midi);
+        reference.process(referenceBuffer, heard);
+
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            render.processor.copyFrom(channel, block * blockSize, buffer, channel, 0, blockSize);
+            render.reference.copyFrom(channel, block * blockSize, referenceBuffer, channel, 0, blockSize);
+        }
+    }
+
+    processor.releaseResources();
+    return render;
+}
+
+bool isBitIdentical(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, int start, int numSamples)
+{
+    for(int channel = 0; channel < numChannels; ++channel)
+    {
+        if(std::memcmp(a.getReadPointer(channel, start), b.getReadPointer(channel, start), sizeof(float) * static_cast<size_t>(numSamples)) != 0)
+            return false;
+    }
+
+    return true;
+}
+}
+
+struct HeardBandTests : juce::UnitTest
+{
+    HeardBandTests() : juce::UnitTest("Bands that are not heard are skipped without changing the rest", "Processor") {}
+
+    void runTest() override
+    {
+        constexpr int blockSize = 512;
+
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa) + ": soloed and muted bands");
+
+            const HeardBands sessions[] {{false, true, false}, {true, false, true}, {true, true, false}};
+            for(const auto& heard : sessions)
+            {
+                const auto render = renderHeard(isa, blockSize, [&heard](int){ return heard; }, [](int){ return -12.0f; });
+                expect(isBitIdentical(render.processor, render.reference, 0, numBlocks * blockSize),
+                       "bands heard " + juce::String(heard[0] ? "0" : "") + juce::String(heard[1] ? "1" : "") + juce::String(heard[2] ? "2" : ""));
+            }
+
+            beginTest(DSPKernels::getIsaName(isa) + ": releasing a solo");
+            testRelease(isa, blockSize);
+        }
+    }
+
+    /*
+     Band 1 is soloed from block soloOn to soloOff, and the low tone in band 0 drops by 20 dB halfway through. The
+     reference keeps compressing band 0 all along, so it follows the drop. The processor skipped band 0, which has to
+     settle on its level when the solo is released rather than pick up from the level before the solo: its level
+     error starts small and only shrinks from there
+     */
+    void testRelease(DSPKernels::Isa isa, int blockSize)
+    {
+        constexpr int soloOn = 40, levelDrop = 70, soloOff = 100;
+        const HeardBands all {true, true, true}, soloed {false, true, false};
+
+        const auto render = renderHeard(isa, blockSize,
+                                        [&](int block){ return block >= soloOn && block < soloOff ? soloed : all; },
+                                        [](int block){ return block < levelDrop ? -6.0f : -26.0f; });
+
+        expect(isBitIdentical(render.processor, render.reference, 0, soloOn * blockSize), "before the solo");
+
+        // Picking up from before the solo is 2 dB off at first, and still 0.5 dB off 100 ms later. A settled band has
+        // to come within 0.01 dB of one that never stopped by then
+        constexpr int settleBlocks = 10;
+        auto previousErrorDb = 0.0f;
+
+        for(int block = soloOff; block < numBlocks; ++block)
+        {
+            const auto errorDb = std::abs(getBlockLevelDb(render.processor, block, blockSize) - getBlockLevelDb(render.reference, block, blockSize));
+            const auto boundDb = block == soloOff ? 0.5f : block < soloOff + settleBlocks ? previousErrorDb : 0.01f;
+            expect(errorDb <= boundDb, "block " + juce::String(block) + " is " + juce::String(errorDb, 3) + " dB off, bound "
+                                       + juce::String(boundDb, 3) + " dB");
+
+            if(block == soloOff)
+                logMessage("level error on release: " + juce::String(errorDb, 3) + " dB");
+
+            previousErrorDb = errorDb;
+        }
+    }
+};
+
+static HeardBandTests heardBandTests;
+
+/*
+ While every band is bypassed the processor only runs the crossover's allpass, and handing the crossover's state
+ between that and the split, both ways, has to leave what is heard the same as the band sum would have been. The
+ thresholds are left at 0 dBFS, where the compressors never touch the tones, so the band sum stays the allpass of the
+ input even while the bands are in. Toggling Bypass Phase Match while the passthrough runs must not switch it
+ between the allpass and a plain copy; that waits until the passthrough starts again
+ */
+struct PassthroughTests : juce::UnitTest
+{
+    PassthroughTests() : juce::UnitTest("The passthrough picks up where the band sum leaves off", "Processor") {}
+
+    void runTest() override
+    {
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa) + ": handing over to the passthrough and back");
+            testHandoff(isa, 512);
+        }
+    }
+
+    void testHandoff(DSPKernels::Isa isa, int blockSize)
+    {
+        // The allpass and the band sum round differently, and nothing else may tell them apart
+        constexpr float tolerance = 1.0e-5f;
+
+        // By the last bypass Bypass Phase Match is off, so after the crossfade the output is the input itself
+        constexpr int lastBypass = 170;
+        const auto copyStart = lastBypass + static_cast<int>(std::ceil(gainRampSeconds * sampleRate / blockSize)) + 1;
+
+        SimpleMBCompAudioProcessor processor;
+        processor.setForcedKernelIsa(isa);
+        processor.setParallelBandThreshold(0);
+        setAllBypassed(processor, true);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        ReferencePath reference(processor, isa, blockSize);
+
+        const auto& bypassPhaseMatchID = Params::GetParams().at(Params::Names::Bypass_Phase_Match);
+        const HeardBands all {true, true, true};
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize), input(numChannels, blockSize), referenceBuffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        std::mt19937 noise(1);
+        int64_t position = 0;
+        auto largestError = 0.0f;
+
+        for(int block = 0; block < numBlocks; ++block)
+        {
+            switch(block)
+            {
+                case 60: setBandParameter(processor, Params::BandParam::Bypassed, 1, 0.0f); break;
+                case 100: setAllBypassed(processor, true); break;
+                case 130: setParameter(processor, bypassPhaseMatchID, 0.0f); break;
+                case 140: setParameter(processor, bypassPhaseMatchID, 1.0f); break;
+                case 145: setParameter(processor, bypassPhaseMatchID, 0.0f); break;
+                case 150: setBandParameter(processor, Params::BandParam::Bypassed, 1, 0.0f); break;
+                case lastBypass: setAllBypassed(processor, true); break;
+                default: break;
+            }
+
+            fillTones(buffer, position, noise, -12.0f);
+            input.makeCopyOf(buffer);
+            referenceBuffer.makeCopyOf(buffer);
+
+            processor.processBlock(buffer, midi);
+            reference.process(referenceBuffer, all);
+
+            if(block < lastBypass)
+            {
+                for(int channel = 0; channel < numChannels; ++channel)
+                {
+                    for(int i = 0; i < blockSize; ++i)
+                    {
+                        largestError = std::max(largestError, std::abs(buffer.getSample(channel, i) - referenceBuffer.getSample(channel, i)));
+                    }
+                }
+            }
+            else if(block >= copyStart)
+            {
+                expect(isBitIdentical(buffer, input, 0, blockSize), "block " + juce::String(block) + " is not the input");
+            }
+        }
+
+        expect(largestError < tolerance, "the output is " + juce::String(largestError, 8) + " off the band sum");
+        logMessage("largest difference from the band sum: " + juce::String(largestError, 8));
+
+        processor.releaseResources();
+    }
+};
+
+static PassthroughTests passthroughTests;
+
+/*
+ Once the input has stayed below the silence floor for longer than the tail, the processor writes silence without
+ processing, and when the input comes back it restarts from silence. The tail has to be long enough that this is
+ where a processor that never stopped would be too, give or take the floor, and it has to follow the release times,
+ the crossovers and the floor it is worked out from
+ */
+struct IdleTests : juce::UnitTest
+{
+    IdleTests() : juce::UnitTest("Going idle below the silence floor", "Processor") {}
+
+    void runTest() override
+    {
+        beginTest("The tail follows the release times, the crossovers and the floor");
+        testTailLength();
+
+        beginTest("Silence after the tail, and the same output when the input comes back");
+        testIdle(512);
+    }
+
+    void testTailLength()
+    {
+        SimpleMBCompAudioProcessor processor;
+        const auto lowCrossoverID = Params::getCrossoverParamID(0, numBands);
+
+        auto setReleases = [&](float slowestMs)
+        {
+            for(size_t band = 0; band < numBands; ++band)
+            {
+                setBandParameter(processor, Params::BandParam::Release, band, band == 1 ? slowestMs : 5.0f);
+            }
+        };
+
+        // Seconds for a time constant to fall from full scale to the floor
+        auto getTail = [](double timeConstant, double floorDb)
+        {
+            return timeConstant * std::log(1.0 / juce::Decibels::decibelsToGain(floorDb, -1000.0));
+        };
+
+        auto expectTail = [&](float floorDb, double expected, const juce::String& what)
+        {
+            processor.setSilenceFloorDb(floorDb);
+            const auto tail = processor.getTailLengthSeconds();
+            expectWithinAbsoluteError(tail, expected, expected * 1.0e-6, what + ": " + juce::String(tail, 6) + " s");
+        };
+
+        // The envelope releases with a time constant of release / 2 pi
+        const auto twoPi = juce::MathConstants<double>::twoPi;
+        setReleases(250.0f);
+        expectTail(-120.0f, getTail(0.25 / twoPi, -120.0), "250 ms release, -120 dB floor");
+        expectTail(-60.0f, getTail(0.25 / twoPi, -60.0), "250 ms release, -60 dB floor");
+
+        setReleases(500.0f);
+        expectTail(-120.0f, getTail(0.5 / twoPi, -120.0), "500 ms release, -120 dB floor");
+
+        // A floor below -200 dB counts as -200 dB
+        expectTail(-300.0f, getTail(0.5 / twoPi, -200.0), "500 ms release, -300 dB floor");
+
+        // With short releases, the lowest crossover's poles ring the longest
+        setReleases(5.0f);
+        setParameter(processor, lowCrossoverID, 50.0f);
+        expectTail(-120.0f, getTail(juce::MathConstants<double>::sqrt2 / (twoPi * 50.0), -120.0), "5 ms releases, 50 Hz crossover");
+    }
+
+    /*
+     Tones, then noise 20 dB below the floor until the processor has been idle for two blocks, then the tones again.
+     The same session is rendered with the floor far below the noise, so that processor never goes idle and is only
+     the tail further on when the tones come back
+     */
+    void testIdle(int blockSize)
+    {
+        constexpr float floorDb = -120.0f;
+        constexpr int quietStart = 40;
+
+        // The first block that takes the quiet past the tail
+        const auto tailSamples = static_cast<int64_t>(std::ceil(makeProcessor(floorDb)->getTailLengthSeconds() * sampleRate));
+        const auto firstIdleBlock = quietStart + static_cast<int>((tailSamples + blockSize - 1) / blockSize) - 1;
+        const auto quietEnd = firstIdleBlock + 2;
+
+        const auto idling = renderIdle(blockSize, floorDb, quietStart, quietEnd);
+        const auto neverIdle = renderIdle(blockSize, -200.0f, quietStart, quietEnd);
+
+        auto isSilent = [&](int block)
+        {
+            for(int channel = 0; channel < numChannels; ++channel)
+            {
+                for(int i = block * blockSize; i < (block + 1) * blockSize; ++i)
+                {
+                    if(idling.getSample(channel, i) != 0.0f)
+                        return false;
+                }
+            }
+
+            return true;
+        };
+
+        expect(! isSilent(firstIdleBlock - 1), "the block before the tail ends is still processed");
+        for(int block = firstIdleBlock; block < quietEnd; ++block)
+        {
+            expect(isSilent(block), "block " + juce::String(block) + " is past the tail but not silent");
+        }
+
+        // Restarting from silence leaves out what the other processor still remembers, which is below the floor. The
+        // gain computers read their envelopes against the threshold though, the lowest of which setBands puts at -42 dB
+        const auto tolerance = juce::Decibels::decibelsToGain(floorDb + 42.0f);
+        auto largestError = 0.0f;
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            for(int i = quietEnd * blockSize; i < numBlocks * blockSize; ++i)
+            {
+                largestError = std::max(largestError, std::abs(idling.getSample(channel, i) - neverIdle.getSample(channel, i)));
+            }
+        }
+
+        expect(largestError <= tolerance, "after idling the output is " + juce::String(largestError, 10) + " off");
+        logMessage("largest difference after idling: " + juce::String(largestError, 10));
+    }
+
+    // Compressing bands that release over 200 ms
+    std::unique_ptr<SimpleMBCompAudioProcessor> makeProcessor(float floorDb)
+    {
+        auto processor = std::make_unique<SimpleMBCompAudioProcessor>();
+        setBands(*processor);
+        for(size_t band = 0; band < numBands; ++band)
+        {
+            setBandParameter(*processor, Params::BandParam::Release, band, 200.0f);
+        }
+
+        processor->setSilenceFloorDb(floorDb);
+        return processor;
+    }
+
+    juce::AudioBuffer<float> renderIdle(int blockSize, float floorDb, int quietStart, int quietEnd)
+    {
+        auto processor = makeProcessor(floorDb);
+        processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output(numChannels, numBlocks * blockSize);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        std::mt19937 noise(1);
+        int64_t position = 0;
+        const auto quietLevel = juce::Decibels::decibelsToGain(-140.0f, -1000.0f);
+
+        for(int block = 0; block < numBlocks; ++block)
+        {
+            if(block >= quietStart && block < quietEnd)
+            {
+                for(int channel = 0; channel < numChannels; ++channel)
+                {
+                    for(int i = 0; i < blockSize; ++i)
+                    {
+                        buffer.setSample(channel, i, quietLevel * (2.0f * static_cast<float>(noise() >> 8) / 16777216.0f - 1.0f));
+                    }
+                }
+            }
+            else
+            {
+                fillTones(buffer, position, noise, -12.0f);
+            }
+
+            processor->processBlock(buffer, midi);
+            for(int channel = 0; channel < numChannels; ++channel)
+            {
+                output.copyFrom(channel, block * blockSize, buffer, channel, 0, blockSize);
+            }
+        }
+
+        processor->releaseResources();
+        return output;
+    }
+};
+
+static IdleTests idleTests;
+
+/*
+ While every channel carries the same input the processor only processes the first and copies it, and when they part
+ again the others take over the first channel's state. The tiled renders above go dual mono on both sides, so a state
+ copied wrongly would go unnoticed there. Here the same session is rendered with dual mono turned off, and every
+ channel has to stay within the floor of that, going in, while in it and coming out
+ */
+struct DualMonoTests : juce::UnitTest
+{
+    DualMonoTests() : juce::UnitTest("Dual mono sounds the same as processing every channel", "Processor") {}
+
+    void runTest() override
+    {
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa) + ": in and out of dual mono");
+            testDualMono(isa, 512);
+        }
+    }
+
+    // The channels are the same from block sameStart to sameEnd, for long enough to go dual mono halfway through
+    void testDualMono(DSPKernels::Isa isa, int blockSize)
+    {
+        constexpr int sameStart = 30, sameEnd = 120;
+
+        const auto dualMono = renderDualMono(isa, blockSize, true, sameStart, sameEnd);
+        const auto stereo = renderDualMono(isa, blockSize, false, sameStart, sameEnd);
+
+        expect(isBitIdentical(dualMono, stereo, 0, sameStart * blockSize), "before the channels are the same");
+
+        // Dual mono copies the first channel, which the last blocks of the stretch have to show
+        expect(std::memcmp(dualMono.getReadPointer(0, (sameEnd - 1) * blockSize), dualMono.getReadPointer(1, (sameEnd - 1) * blockSize),
+                           sizeof(float) * static_cast<size_t>(blockSize)) == 0, "the input never went dual mono");
+
+        // The channels' states agree down to the floor before they are merged, but the gain computers read their
+        // envelopes against the threshold, the lowest of which setBands puts at -42 dB
+        const auto tolerance = juce::Decibels::decibelsToGain(SimpleMBCompAudioProcessor::defaultSilenceFloorDb + 42.0f);
+        auto largestError = 0.0f;
+        for(int channel = 0; channel < numChannels; ++channel)
+        {
+            for(int i = sameStart * blockSize; i < numBlocks * blockSize; ++i)
+            {
+                largestError = std::max(largestError, std::abs(dualMono.getSample(channel, i) - stereo.getSample(channel, i)));
+            }
+        }
+
+        expect(largestError <= tolerance, "dual mono is " + juce::String(largestError, 10) + " off");
+        logMessage("largest difference from processing every channel: " + juce::String(largestError, 10));
+    }
+
+    juce::AudioBuffer<float> renderDualMono(DSPKernels::Isa isa, int blockSize, bool dualMonoEnabled, int sameStart, int sameEnd)
+    {
+        SimpleMBCompAudioProcessor processor;
+        processor.setForcedKernelIsa(isa);
+        processor.setParallelBandThreshold(0);
+        processor.setDualMonoEnabled(dualMonoEnabled);
+        setBands(processor);
+
+        // A tail of some 40 blocks
+        for(size_t band = 0; band < numBands; ++band)
+        {
+            setBandParameter(processor, Params::BandParam::Release, band, 200.0f);
+        }
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output(numChannels, numBlocks * blockSize);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        std::mt19937 noise(1);
+        int64_t position = 0;
+
+        for(int block = 0; block < numBlocks; ++block)
+        {
+            fillTones(buffer, position, noise, -12.0f);
+            if(block >= sameStart && block < sameEnd)
+            {
+                buffer.copyFrom(1, 0, buffer, 0, 0, blockSize);
+            }
+
+            processor.processBlock(buffer, midi);
+            for(int channel = 0; channel < numChannels; ++channel)
+            {
+                output.copyFrom(channel, block * blockSize, buffer, channel, 0, blockSize);
+            }
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+};
+
+static DualMonoTests dualMonoTests;
+
+/*
+ Host blocks larger than the block size the processor was prepared for are processed in chunks of at most that size,
+ and have to give the same bits as the host delivering those chunks itself. The host block sizes cycle through
+ multiples of the prepared size, sizes in between and ones below it, while the script from the tiled renders runs
+ */
+struct ChunkTests : juce::UnitTest
+{
+    ChunkTests() : juce::UnitTest("Blocks larger than prepared match prepared-size blocks", "Processor") {}
+
+    void runTest() override
+    {
+        for(auto isa : {DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512})
+        {
+            if(! DSPKernels::isSupported(isa))
+                continue;
+
+            beginTest(DSPKernels::getIsaName(isa) + ": host blocks up to eight times the prepared size");
+            testChunks(isa, 256);
+        }
+    }
+
+    void testChunks(DSPKernels::Isa isa, int preparedBlockSize)
+    {
+        const int hostBlockSizes[] {1000, 4 * preparedBlockSize, 2049, preparedBlockSize, 37, 8 * preparedBlockSize + 1};
+
+        SimpleMBCompAudioProcessor large, prepared;
+        for(auto* processor : {&large, &prepared})
+        {
+            processor->setForcedKernelIsa(isa);
+            processor->setParallelBandThreshold(0);
+            setBands(*processor);
+
+            processor->setRateAndBufferSizeDetails(sampleRate, preparedBlockSize);
+            processor->prepareToPlay(sampleRate, preparedBlockSize);
+        }
+
+        juce::AudioBuffer<float> buffer, expected;
+        juce::MidiBuffer midi;
+        std::mt19937 noise(1);
+        double phase = 0;
+        auto identical = true;
+
+        for(int block = 0; block < numBlocks && identical; ++block)
+        {
+            runScript(large, block);
+            runScript(prepared, block);
+
+            const auto numSamples = hostBlockSizes[static_cast<size_t>(block) % std::size(hostBlockSizes)];
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            fillInput(buffer, block, phase, noise);
+            expected.makeCopyOf(buffer);
+
+            large.processBlock(buffer, midi);
+            for(int start = 0; start < numSamples; start += preparedBlockSize)
+            {
+                juce::AudioBuffer<float> chunk(expected.getArrayOfWritePointers(), numChannels, start, juce::jmin(preparedBlockSize, numSamples - start));
+                prepared.processBlock(chunk, midi);
+            }
+
+            identical = isBitIdentical(buffer, expected, 0, numSamples);
+            expect(identical, "block " + juce::String(block) + " of " + juce::String(numSamples) + " samples");
+        }
+
+        large.releaseResources();
+        prepared.releaseResources();
+    }
+};
+
+static ChunkTests chunkTests;
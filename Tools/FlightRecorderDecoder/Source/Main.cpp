@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 16 Oct 2026 11:52:40pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/FlightRecorder.h"
+
+#include <iostream>
+
+/*
+ Turns a file saved from the plugin's flight recorder (see Source/DSP/FlightRecorder.h) into CSV
+
+ Build FlightRecorderDecoder.jucer (Projucer --resave, then make in Builds/LinuxMakefile, or the Xcode project) and
+ run it on a file saved with "Save flight recording..." from the deadline readout in the editor. Every block becomes
+ one row: its time since the first block and on the wall clock, its size, how long it took and how much of its
+ budget that was, the parameter snapshot it ran with, what it skipped, and each band's levels and gain reduction.
+ A summary goes to stderr: the time span, the overruns, the worst block and the deepest gain reduction per band.
+
+ Usage: FlightRecorderDecoder FILE [--output CSV]
+
+ Writes the CSV to stdout unless --output is given. Exits with 2 if the file cannot be read or the CSV cannot be written.
+ */
+
+namespace
+{
+juce::String toCsv(float db)
+{
+    return std::isinf(db) ? juce::String(db < 0.f ? "-inf" : "inf") : juce::String(db, 2);
+}
+
+juce::String getCsvHeader(int numBands)
+{
+    juce::String header = "block,time_s,wall_clock,samples,sample_rate,elapsed_us,load_percent,snapshot_version,"
+                          "parameters_changed,idle,dual_mono,pass_through";
+
+    for(int band = 1; band <= numBands; ++band)
+    {
+        const auto prefix = ",band" + juce::String(band) + "_";
+        header << prefix << "in_rms_db" << prefix << "in_peak_db" << prefix << "out_rms_db"
+               << prefix << "out_peak_db" << prefix << "gain_reduction_db";
+    }
+
+    return header;
+}
+
+double getLoad(const FlightRecording::DecodedRecord& record)
+{
+    if(record.numSamples <= 0 || record.sampleRate <= 0.f)
+        return 0.0;
+
+    return record.elapsedMicroseconds * 1.0e-6 * record.sampleRate / record.numSamples;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::StringArray arguments(argv + 1, argc - 1);
+    const auto usage = "Usage: FlightRecorderDecoder FILE [--output CSV]";
+
+    if(arguments.isEmpty() || arguments[0].startsWith("--"))
+    {
+        std::cerr << usage << "\n";
+        return 2;
+    }
+
+    const auto inputFile = juce::File::getCurrentWorkingDirectory().getChildFile(arguments[0]);
+    juce::FileInputStream input(inputFile);
+    FlightRecording::Header header;
+
+    if(! input.openedOk() || ! FlightRecording::readHeader(input, header))
+    {
+        std::cerr << "Not a flight recording this decoder can read: " << inputFile.getFullPathName() << "\n";
+        return 2;
+    }
+
+    // Places a record on the wall clock by its distance from the tick reading taken when the file was written
+    auto getMilliseconds = [&header](juce::int64 ticks)
+    {
+        return header.millisecondsSinceEpochAtWrite
+             + juce::roundToInt(1000.0 * static_cast<double>(ticks - header.ticksAtWrite) / static_cast<double>(header.ticksPerSecond));
+    };
+
+    juce::MemoryOutputStream csv;
+    csv << getCsvHeader(header.numBands) << "\n";
+
+    FlightRecording::DecodedRecord record;
+    juce::int64 firstTicks = 0;
+    int numRecords = 0, numOverruns = 0, numParameterChanges = 0;
+    double maxLoad = 0.0, maxLoadSeconds = 0.0;
+    std::vector<float> deepestGainReductionDb(static_cast<size_t>(header.numBands), 0.f);
+
+    while(numRecords < header.numRecords && FlightRecording::readRecord(input, header.numBands, record))
+    {
+        using namespace FlightRecording;
+
+        if(numRecords == 0)
+            firstTicks = record.startTicks;
+
+        const auto seconds = static_cast<double>(record.startTicks - firstTicks) / static_cast<double>(header.ticksPerSecond);
+        const auto load = getLoad(record);
+
+        numOverruns += load > 1.0 ? 1 : 0;
+        numParameterChanges += (record.flags & ParametersChanged) != 0 ? 1 : 0;
+
+        if(load > maxLoad)
+        {
+            maxLoad = load;
+            maxLoadSeconds = seconds;
+        }
+
+        csv << juce::String(numRecords) << "," << juce::String(seconds, 6) << ","
+            << juce::Time(getMilliseconds(record.startTicks)).toISO8601(true) << ","
+            << juce::String(record.numSamples) << "," << juce::String(record.sampleRate, 0) << ","
+            << juce::String(record.elapsedMicroseconds, 1) << "," << juce::String(load * 100.0, 1) << ","
+            << juce::String(record.snapshotVersion) << ","
+            << ((record.flags & ParametersChanged) != 0 ? "1" : "0") << ","
+            << ((record.flags & Idle) != 0 ? "1" : "0") << ","
+            << ((record.flags & DualMono) != 0 ? "1" : "0") << ","
+            << ((record.flags & PassThrough) != 0 ? "1" : "0");
+
+        for(size_t band = 0; band < record.bands.size(); ++band)
+        {
+            const auto& levels = record.bands[band];
+            csv << "," << toCsv(levels.inputRmsDb) << "," << toCsv(levels.inputPeakDb) << "," << toCsv(levels.outputRmsDb)
+                << "," << toCsv(levels.outputPeakDb) << "," << toCsv(levels.gainReductionDb);
+
+            deepestGainReductionDb[band] = juce::jmin(deepestGainReductionDb[band], levels.gainReductionDb);
+        }
+
+        csv << "\n";
+        ++numRecords;
+    }
+
+    if(numRecords < header.numRecords)
+        std::cerr << "The file ends after " << numRecords << " of its " << header.numRecords << " records\n";
+
+    const auto outputPath = arguments[arguments.indexOf("--output") + 1];
+
+    if(arguments.contains("--output"))
+    {
+        const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+
+        if(outputPath.isEmpty() || ! outputFile.replaceWithData(csv.getData(), csv.getDataSize()))
+        {
+            std::cerr << "Could not write " << outputPath << "\n";
+            return 2;
+        }
+    }
+    else
+    {
+        std::cout << csv.toString();
+    }
+
+    std::cerr << numRecords << " blocks";
+
+    if(numRecords > 0)
+    {
+        const auto lastSeconds = static_cast<double>(record.startTicks - firstTicks) / static_cast<double>(header.ticksPerSecond);
+        std::cerr << " over " << juce::String(lastSeconds, 2) << " s, from "
+                  << juce::Time(getMilliseconds(firstTicks)).toString(true, true, true, true) << "\n"
+                  << numOverruns << " overruns, the worst at " << juce::String(maxLoad * 100.0, 1) << "% of its budget, "
+                  << juce::String(maxLoadSeconds, 3) << " s in\n"
+                  << numParameterChanges << " blocks with parameter changes\n"
+                  << "Deepest gain reduction per band:";
+
+        for(auto gainReductionDb : deepestGainReductionDb)
+            std::cerr << " " << juce::String(gainReductionDb, 1) << " dB";
+    }
+
+    std::cerr << std::endl;
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    Interposer.cpp
+    Created: 16 Oct 2026 7:31:20pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include "Interposer.h"
+#include "../../../Source/DSP/RealtimeCheck.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if ! SIMPLEMBCOMP_REALTIME_CHECKS
+ #error "The harness needs SIMPLEMBCOMP_REALTIME_CHECKS=1, or the processor opens no scopes"
+#endif
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace
+{
+// Past this many, violations are still counted but their stacks are not printed
+constexpr int maxPrintedStacks = 16;
+constexpr int maxStackFrames = 48;
+
+std::atomic<int> numViolations { 0 };
+std::atomic<bool> abortOnViolation { false };
+
+using MutexLock = int (*)(pthread_mutex_t*);
+std::atomic<MutexLock> nextMutexLock { nullptr };
+
+// write rather than stdio, which may allocate or lock
+void print(const char* text)
+{
+    [[maybe_unused]] auto result = ::write(STDERR_FILENO, text, std::strlen(text));
+}
+
+[[gnu::noinline]] void check(const char* function)
+{
+    if(RealtimeCheck::depth == 0)
+        return;
+
+    // Printing the stack may call the checked functions itself, which are not violations
+    const auto depth = RealtimeCheck::depth;
+    RealtimeCheck::depth = 0;
+
+    const auto index = numViolations.fetch_add(1) + 1;
+
+    if(index <= maxPrintedStacks)
+    {
+        print("\n*** Real-time violation: ");
+        print(function);
+        print(" called inside the audio callback\n");
+
+        void* frames[maxStackFrames];
+        const auto numFrames = backtrace(frames, maxStackFrames);
+
+        // The first frame is this function
+        backtrace_symbols_fd(frames + 1, numFrames - 1, STDERR_FILENO);
+
+        if(index == maxPrintedStacks)
+            print("*** Further violations are counted but not printed\n");
+    }
+
+    if(abortOnViolation.load())
+        std::abort();
+
+    RealtimeCheck::depth = depth;
+}
+
+void* allocate(const char* function, size_t size, size_t alignment)
+{
+    check(function);
+
+    if(size == 0)
+        size = 1;
+
+    return alignment > alignof(std::max_align_t) ? __libc_memalign(alignment, size) : __libc_malloc(size);
+}
+
+void* allocateOrThrow(const char* function, size_t size, size_t alignment)
+{
+    if(auto* pointer = allocate(function, size, alignment))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void release(const char* function, void* pointer)
+{
+    // free(nullptr) does nothing, so it is not worth a report
+    if(pointer != nullptr)
+        check(function);
+
+    __libc_free(pointer);
+}
+}
+
+namespace Interposer
+{
+void prepare(bool shouldAbortOnViolation)
+{
+    abortOnViolation = shouldAbortOnViolation;
+
+    // The first backtrace loads libgcc_s, which allocates. Doing it here keeps that out of the first report
+    void* frames[2];
+    backtrace(frames, 2);
+
+    nextMutexLock = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+}
+
+int getNumViolations()
+{
+    return numViolations.load();
+}
+}
+
+//==============================================================================
+extern "C"
+{
+void* malloc(size_t size) noexcept
+{
+    check("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    check("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept
+{
+    check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept
+{
+    release("free", pointer);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+    check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+{
+    check("posix_memalign");
+
+    if(alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    check("pthread_mutex_lock");
+
+    // Locks taken by static constructors can come before prepare
+    auto lock = nextMutexLock.load(std::memory_order_relaxed);
+
+    if(lock == nullptr)
+    {
+        lock = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        nextMutexLock = lock;
+    }
+
+    return lock(mutex);
+}
+}
+
+//==============================================================================
+void* operator new(size_t size) { return allocateOrThrow("operator new", size, 0); }
+void* operator new[](size_t size) { return allocateOrThrow("operator new[]", size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateOrThrow("operator new", size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateOrThrow("operator new[]", size, static_cast<size_t>(alignment)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate("operator new", size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate("operator new[]", size, 0); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate("operator new", size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate("operator new[]", size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { release("operator delete", pointer); }
+void operator delete[](void* pointer) noexcept { release("operator delete[]", pointer); }
+void operator delete(void* pointer, size_t) noexcept { release("operator delete", pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release("operator delete[]", pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release("operator delete", pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release("operator delete[]", pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { release("operator delete", pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { release("operator delete[]", pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release("operator delete", pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release("operator delete[]", pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release("operator delete", pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release("operator delete[]", pointer); }
@@ -0,0 +1,29 @@
+/*
+  ==============================================================================
+
+    Interposer.h
+    Created: 16 Oct 2026 7:31:20pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+ Replacements for the allocator, operator new/delete and pthread_mutex_lock that report any call made while a
+ RealtimeCheck::Scope is open on the calling thread
+
+ They are defined in the executable, which the dynamic linker searches before any shared library, so calls from
+ JUCE and the C++ runtime land here too, the same as with an LD_PRELOAD shim. The allocator forwards to glibc's
+ __libc_* entry points and the lock to the next pthread_mutex_lock, so Linux with glibc only. Each violation
+ prints the function and the stack it was called from (link with -rdynamic to get symbol names).
+ pthread_mutex_trylock is allowed, since it never blocks.
+ */
+namespace Interposer
+{
+// Call at the start of main. With abortOnViolation the first violation aborts, for a debugger or a core dump
+void prepare(bool abortOnViolation);
+
+int getNumViolations();
+}
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 16 Oct 2026 7:44:02pm
+    Author:  Hong Jyun Wang
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/DSP/Params.h"
+#include "Interposer.h"
+
+#include <iostream>
+
+/*
+ Drives SimpleMBCompAudioProcessor headlessly and fails if anything in the audio callback allocates or locks
+
+ Build RealtimeSafety.jucer (Projucer --resave, then make in Builds/LinuxMakefile) and run the executable. Every
+ kernel instruction set the CPU supports is run at several prepared block sizes, with the parallel threshold low
+ enough that the band workers run too. Between blocks the driver moves random parameters, toggles solo, mute and
+ bypass, changes the tile size, the gain control interval and the silence floor, and switches the input between
+ stereo noise, dual mono and long enough stretches of silence for the plugin to go idle. The blocks vary in size up
+ to twice the prepared size, so the chunking of oversized host blocks is covered as well.
+
+ Options:
+     --blocks N    blocks per configuration, 2000 by default
+     --seed N      random seed, 1 by default
+     --abort       abort on the first violation, for a debugger or a core dump
+
+ Exits with 1 if there was any violation. The stacks are printed to stderr as they happen.
+ */
+
+namespace
+{
+struct Configuration
+{
+    double sampleRate;
+    int preparedBlockSize;
+    int parallelBandThreshold;
+};
+
+const Configuration configurations[]
+{
+    { 44100.0, 32, 0 },
+    { 48000.0, 256, 0 },
+    { 48000.0, 512, 128 },
+    { 96000.0, 2048, 512 },
+};
+
+enum class Input
+{
+    Stereo,
+    DualMono,
+    Silence,
+};
+
+juce::RangedAudioParameter& getParameter(SimpleMBCompAudioProcessor& processor, const juce::String& id)
+{
+    auto* parameter = processor.apvts.getParameter(id);
+    jassert(parameter != nullptr);
+    return *parameter;
+}
+
+void setRandomParameter(SimpleMBCompAudioProcessor& processor, juce::Random& random)
+{
+    auto& parameters = processor.getParameters();
+    parameters[random.nextInt(parameters.size())]->setValueNotifyingHost(random.nextFloat());
+}
+
+// Solo, mute and bypass change which bands run at all, so they get more turns than a uniform pick would give them
+void toggleBandSwitch(SimpleMBCompAudioProcessor& processor, juce::Random& random)
+{
+    using namespace Params;
+
+    const BandParam switches[] { BandParam::Solo, BandParam::Mute, BandParam::Bypassed };
+    const auto band = static_cast<size_t>(random.nextInt(static_cast<int>(SimpleMBCompAudioProcessor::NumBands)));
+
+    auto& parameter = getParameter(processor, getBandParamID(switches[random.nextInt(3)], band,
+                                                            SimpleMBCompAudioProcessor::NumBands));
+    parameter.setValueNotifyingHost(parameter.getValue() < 0.5f ? 1.0f : 0.0f);
+}
+
+void changeTuning(SimpleMBCompAudioProcessor& processor, juce::Random& random)
+{
+    const int tileSizes[] { 0, 64, 100, SimpleMBCompAudioProcessor::defaultTileSize };
+    processor.setTileSize(tileSizes[random.nextInt(4)]);
+
+    // 12 is rounded down to 8
+    const int controlIntervals[] { SimpleMBCompAudioProcessor::defaultGainControlInterval, 12, 16, 32 };
+    processor.setGainControlInterval(controlIntervals[random.nextInt(4)]);
+
+    processor.setSilenceFloorDb(random.nextBool() ? SimpleMBCompAudioProcessor::defaultSilenceFloorDb : -60.f);
+}
+
+void fillInput(juce::AudioBuffer<float>& buffer, int numSamples, Input input, juce::Random& random)
+{
+    for(int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* samples = buffer.getWritePointer(channel);
+
+        if(input == Input::Silence)
+            juce::FloatVectorOperations::clear(samples, numSamples);
+        else if(input == Input::DualMono && channel > 0)
+            juce::FloatVectorOperations::copy(samples, buffer.getReadPointer(0), numSamples);
+        else
+            for(int i = 0; i < numSamples; ++i)
+                samples[i] = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+    }
+}
+
+// Returns the number of blocks processed
+int run(SimpleMBCompAudioProcessor& processor, const Configuration& configuration, int numBlocks, juce::Random& random)
+{
+    processor.setParallelBandThreshold(configuration.parallelBandThreshold);
+    processor.setRateAndBufferSizeDetails(configuration.sampleRate, configuration.preparedBlockSize);
+    processor.prepareToPlay(configuration.sampleRate, configuration.preparedBlockSize);
+
+    const auto maxBlockSize = 2 * configuration.preparedBlockSize;
+    juce::AudioBuffer<float> buffer(juce::jmax(processor.getTotalNumInputChannels(),
+                                               processor.getTotalNumOutputChannels()), maxBlockSize);
+    juce::MidiBuffer midi;
+
+    auto input = Input::Stereo;
+    int blocksUntilInputChange = 0;
+
+    for(int block = 0; block < numBlocks; ++block)
+    {
+        if(--blocksUntilInputChange <= 0)
+        {
+            input = static_cast<Input>(random.nextInt(3));
+
+            // Silence has to outlast the tail before the plugin goes idle, and a second is longer than any tail
+            blocksUntilInputChange = input == Input::Silence
+                                   ? static_cast<int>(configuration.sampleRate / configuration.preparedBlockSize) + 10
+                                   : 1 + random.nextInt(200);
+        }
+
+        const auto change = random.nextInt(100);
+
+        if(change < 10)
+            setRandomParameter(processor, random);
+        else if(change < 13)
+            toggleBandSwitch(processor, random);
+        else if(change < 14)
+            changeTuning(processor, random);
+
+        const auto numSamples = 1 + random.nextInt(maxBlockSize);
+        fillInput(buffer, numSamples, input, random);
+
+        // A host hands the processor a buffer of exactly the block size, without copying the samples
+        juce::AudioBuffer<float> hostBuffer(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+        processor.processBlock(hostBuffer, midi);
+    }
+
+    processor.releaseResources();
+    return numBlocks;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::StringArray arguments(argv + 1, argc - 1);
+
+    auto getOption = [&arguments](const juce::String& name, int defaultValue)
+    {
+        const auto index = arguments.indexOf(name);
+        return index >= 0 && index + 1 < arguments.size() ? arguments[index + 1].getIntValue() : defaultValue;
+    };
+
+    const auto numBlocks = getOption("--blocks", 2000);
+    juce::Random random(getOption("--seed", 1));
+
+    Interposer::prepare(arguments.contains("--abort"));
+
+    // The parameter tree needs the message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    SimpleMBCompAudioProcessor processor;
+    int totalBlocks = 0;
+
+    for(auto isa : { DSPKernels::Isa::Scalar, DSPKernels::Isa::SSE2, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512 })
+    {
+        if(! DSPKernels::isSupported(isa))
+            continue;
+
+        processor.setForcedKernelIsa(isa);
+
+        for(const auto& configuration : configurations)
+        {
+            const auto violationsBefore = Interposer::getNumViolations();
+            totalBlocks += run(processor, configuration, numBlocks, random);
+
+            std::cout << DSPKernels::getIsaName(isa) << ", " << configuration.sampleRate << " Hz, "
+                      << configuration.preparedBlockSize << " samples: "
+                      << Interposer::getNumViolations() - violationsBefore << " violations" << std::endl;
+        }
+    }
+
+    const auto numViolations = Interposer::getNumViolations();
+    std::cout << totalBlocks << " blocks, " << numViolations << " real-time violations" << std::endl;
+
+    return numViolations == 0 ? 0 : 1;
+}